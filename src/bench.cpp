@@ -0,0 +1,504 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <iostream>
+#include <thread>
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#if ! JUCE_WINDOWS
+#include <sys/resource.h>
+#endif
+
+#include "controller.hpp"
+#include "device.hpp"
+#include "lookandfeel.hpp"
+#include "maincomponent.hpp"
+#include "mididispatcher.hpp"
+#include "midisender.hpp"
+#include "midisink.hpp"
+#include "previewsynth.hpp"
+
+namespace vmc {
+namespace detail {
+static const char* benchHelp =
+    "usage: vmc-bench [options]\n"
+    "  --output=<file>   write results to a JSON file instead of stdout\n"
+    "  --only=<names>    run only these cases, comma separated\n"
+    "  --quick           fewer iterations, for a smoke test\n"
+    "cases: sender, latency, dispatcher, device, paint, startup, synth, idle";
+
+static double nowSeconds() noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks());
+}
+
+/** Times a function run some number of times, in nanoseconds per run. */
+template <typename Function>
+static double nanosPerRun (int runs, Function&& function)
+{
+    const auto start = nowSeconds();
+    for (int i = 0; i < runs; ++i)
+        function (i);
+    return (nowSeconds() - start) * 1.0e9 / (double) juce::jmax (1, runs);
+}
+
+static Device makeDevice (int numControls)
+{
+    Device device;
+    auto dials = device.dials();
+    auto faders = device.faders();
+    dials.removeAllChildren (nullptr);
+    faders.removeAllChildren (nullptr);
+
+    const int numFaders = numControls / 5;
+    for (int i = 0; i < numControls; ++i) {
+        juce::ValueTree ranged (Device::RangedID);
+        ranged.setProperty (Device::ccNumberID, i % 128, nullptr)
+            .setProperty (Device::valueID, (i * 7) % 128, nullptr);
+        (i < numFaders ? faders : dials).appendChild (ranged, nullptr);
+    }
+
+    return device;
+}
+
+struct ProcessUsage {
+    double cpuSeconds = 0.0;
+    juce::int64 contextSwitches = 0;
+};
+
+/** Returns the CPU time and context switches of every thread in this process so far. */
+static ProcessUsage getProcessUsage()
+{
+    ProcessUsage usage;
+#if ! JUCE_WINDOWS
+    rusage ru {};
+    if (getrusage (RUSAGE_SELF, &ru) == 0) {
+        const auto seconds = [] (const timeval& tv) { return (double) tv.tv_sec + (double) tv.tv_usec * 1.0e-6; };
+        usage.cpuSeconds = seconds (ru.ru_utime) + seconds (ru.ru_stime);
+        usage.contextSwitches = (juce::int64) ru.ru_nvcsw + (juce::int64) ru.ru_nivcsw;
+    }
+#endif
+    return usage;
+}
+} // namespace detail
+
+/** Runs each benchmark case and collects the results as JSON. */
+class Bench final {
+public:
+    explicit Bench (bool quickMode)
+        : quick (quickMode)
+    {
+        settingsFolder.createDirectory();
+    }
+
+    ~Bench() { settingsFolder.deleteRecursively(); }
+
+    juce::var run (const juce::StringArray& only)
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("version", VMC_VERSION_STRING);
+        root->setProperty ("os", juce::SystemStats::getOperatingSystemName());
+        root->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty ("cores", juce::SystemStats::getNumCpus());
+        root->setProperty ("time", juce::Time::getCurrentTime().toISO8601 (true));
+        root->setProperty ("quick", quick);
+
+        auto* cases = new juce::DynamicObject();
+        const auto wanted = [&only] (const char* name) { return only.isEmpty() || only.contains (name); };
+
+        if (wanted ("sender"))
+            cases->setProperty ("sender", benchSender());
+        if (wanted ("latency"))
+            cases->setProperty ("latency", benchLatency());
+        if (wanted ("dispatcher"))
+            cases->setProperty ("dispatcher", benchDispatcher());
+        if (wanted ("device"))
+            cases->setProperty ("device", benchDevice());
+        if (wanted ("paint"))
+            cases->setProperty ("paint", benchPaint());
+        if (wanted ("startup"))
+            cases->setProperty ("startup", benchStartup());
+        if (wanted ("synth"))
+            cases->setProperty ("synth", benchSynth());
+        if (wanted ("idle"))
+            cases->setProperty ("idle", benchIdle());
+
+        root->setProperty ("cases", cases);
+        return root;
+    }
+
+private:
+    const bool quick;
+    /** Controllers keep their settings here, away from the user's. */
+    const juce::File settingsFolder { juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                          .getNonexistentChildFile ("vmc-bench-settings", {}, false) };
+
+    juce::PropertiesFile::Options settingsOptions() const { return Settings::getOptionsInFolder (settingsFolder); }
+
+    int scaled (int iterations) const noexcept { return quick ? juce::jmax (1, iterations / 20) : iterations; }
+
+    static void log (const juce::String& text) { std::cerr << "vmc-bench: " << text << std::endl; }
+
+    /** Queues messages through the controller as fast as possible, to a sink that drops them. */
+    juce::var benchSender()
+    {
+        log ("sender");
+        const int numMessages = scaled (1000000);
+        Controller controller (std::make_unique<NullMidiSink>(), settingsOptions());
+        auto& sender = controller.getMidiSender();
+        auto& sink = controller.getMidiSink();
+
+        juce::int64 numRetries = 0;
+        const auto start = detail::nowSeconds();
+        for (int i = 0; i < numMessages; ++i) {
+            const auto msg = juce::MidiMessage::controllerEvent (1, i % 128, i % 128);
+            while (! sender.add (msg)) {
+                ++numRetries;
+                std::this_thread::yield();
+            }
+        }
+        const auto queued = detail::nowSeconds();
+
+        while (sink.getNumReceived() < numMessages)
+            std::this_thread::yield();
+        const auto drained = detail::nowSeconds();
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("messages", numMessages);
+        result->setProperty ("add_ns", (queued - start) * 1.0e9 / numMessages);
+        result->setProperty ("messages_per_second", numMessages / (drained - start));
+        result->setProperty ("full_retries", numRetries);
+        result->setProperty ("average_latency_ms", sender.getAverageLatency());
+        result->setProperty ("max_latency_ms", sender.getMaxLatency());
+        return result;
+    }
+
+    /** Plays timestamped notes one at a time into a loopback sink, measuring
+        the time from the note being played to it reaching the sink.
+    */
+    juce::var benchLatency()
+    {
+        log ("latency");
+        const int numNotes = scaled (4000);
+        auto sink = std::make_unique<LoopbackMidiSink> (numNotes);
+        auto& loopback = *sink;
+        Controller controller (std::move (sink), settingsOptions());
+
+        for (int i = 0; i < numNotes; ++i) {
+            const auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+            const auto msg = i % 2 == 0 ? juce::MidiMessage::noteOn (1, 60, (juce::uint8) 100)
+                                        : juce::MidiMessage::noteOff (1, 60);
+            controller.playNote (msg.withTimeStamp (now));
+            if (! loopback.waitForMessages (i + 1, 1000))
+                break;
+        }
+
+        std::vector<double> latencies;
+        for (int i = 0; i < loopback.getNumEvents(); ++i)
+            latencies.push_back (loopback.getEvent (i).getLatency() * 1.0e6);
+        std::sort (latencies.begin(), latencies.end());
+
+        const auto percentile = [&latencies] (double p) {
+            if (latencies.empty())
+                return 0.0;
+            return latencies[(size_t) juce::jlimit (0, (int) latencies.size() - 1, (int) std::ceil (p * 0.01 * (double) latencies.size()) - 1)];
+        };
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("notes", (int) latencies.size());
+        result->setProperty ("p50_us", percentile (50.0));
+        result->setProperty ("p99_us", percentile (99.0));
+        result->setProperty ("max_us", latencies.empty() ? 0.0 : latencies.back());
+        return result;
+    }
+
+    /** Changes dial values with and without a dispatcher listening. */
+    juce::var benchDispatcher()
+    {
+        log ("dispatcher");
+        const int numChanges = scaled (500000);
+        auto device = detail::makeDevice (128);
+        auto dials = device.dials();
+        const int numDials = dials.getNumChildren();
+
+        const auto change = [&dials, numDials] (int i) {
+            // Alternate values so every set is a real change.
+            dials.getChild (i % numDials).setProperty (Device::valueID, (i / numDials) % 2 == 0 ? 127 : 0, nullptr);
+        };
+
+        const auto baseline = detail::nanosPerRun (numChanges, change);
+
+        juce::int64 numMessages = 0;
+        MidiDispatcher dispatch;
+        dispatch.attach (device, [&numMessages] (const juce::MidiMessage&) { ++numMessages; });
+        const auto attached = detail::nanosPerRun (numChanges, change);
+        dispatch.detach();
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("changes", numChanges);
+        result->setProperty ("messages", numMessages);
+        result->setProperty ("baseline_ns", baseline);
+        result->setProperty ("change_ns", attached);
+        result->setProperty ("dispatch_ns", attached - baseline);
+        return result;
+    }
+
+    /** Saves and loads generated devices of increasing size. */
+    juce::var benchDevice()
+    {
+        juce::Array<juce::var> sizes;
+        juce::TemporaryFile temp (".vmc");
+
+        for (const int numControls : { 10, 100, 1000, 10000 }) {
+            log ("device " + juce::String (numControls));
+            const auto device = detail::makeDevice (numControls);
+            const int runs = juce::jmax (1, scaled (20000 / numControls + 10));
+
+            const auto saveNs = detail::nanosPerRun (runs, [&] (int) { device.save (temp.getFile()); });
+            Device loaded;
+            const auto loadNs = detail::nanosPerRun (runs, [&] (int) { loaded.load (temp.getFile()); });
+            jassert (loaded.dials().getNumChildren() + loaded.faders().getNumChildren() == numControls);
+
+            auto* size = new juce::DynamicObject();
+            size->setProperty ("controls", numControls);
+            size->setProperty ("runs", runs);
+            size->setProperty ("bytes", temp.getFile().getSize());
+            size->setProperty ("save_ms", saveNs * 1.0e-6);
+            size->setProperty ("load_ms", loadNs * 1.0e-6);
+            sizes.add (size);
+        }
+
+        return sizes;
+    }
+
+    /** Paints the main component and LookAndFeel sliders into an image. */
+    juce::var benchPaint()
+    {
+        log ("paint");
+        vmc::LookAndFeel look;
+        juce::LookAndFeel::setDefaultLookAndFeel (&look);
+
+        auto* result = new juce::DynamicObject();
+
+        {
+            Controller controller (std::make_unique<NullMidiSink>(), settingsOptions());
+            MainComponent main (controller);
+            main.setDevice (controller.device());
+
+            juce::Image image (juce::Image::ARGB, main.getWidth(), main.getHeight(), true);
+            const auto paint = [&] (int) {
+                juce::Graphics g (image);
+                main.paintEntireComponent (g, true);
+            };
+
+            result->setProperty ("first_ms", detail::nanosPerRun (1, paint) * 1.0e-6);
+            main.getPaintProfiler().reset();
+            const int runs = scaled (200);
+            result->setProperty ("runs", runs);
+            result->setProperty ("main_ms", detail::nanosPerRun (runs, paint) * 1.0e-6);
+            result->setProperty ("components", main.getPaintProfiler().toVar());
+        }
+
+        {
+            juce::Slider dial (juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::NoTextBox);
+            juce::Slider fader (juce::Slider::LinearVertical, juce::Slider::NoTextBox);
+            dial.setSize (64, 64);
+            fader.setSize (40, 200);
+
+            juce::Image image (juce::Image::ARGB, 200, 200, true);
+            const int runs = scaled (20000);
+            const auto params = dial.getRotaryParameters();
+
+            const auto dialNs = detail::nanosPerRun (runs, [&] (int i) {
+                juce::Graphics g (image);
+                look.drawRotarySlider (g, 0, 0, 64, 64, (float) (i % 128) / 127.0f,
+                                       params.startAngleRadians, params.endAngleRadians, dial);
+            });
+
+            const auto faderNs = detail::nanosPerRun (runs, [&] (int i) {
+                juce::Graphics g (image);
+                look.drawLinearSlider (g, 0, 0, 40, 200, (float) (i % 200), 0.0f, 200.0f,
+                                       juce::Slider::LinearVertical, fader);
+            });
+
+            result->setProperty ("dial_us", dialNs * 1.0e-3);
+            result->setProperty ("fader_us", faderNs * 1.0e-3);
+        }
+
+        juce::LookAndFeel::setDefaultLookAndFeel (nullptr);
+        return result;
+    }
+
+    /** Times a cold start: from creating the controller to the first frame of
+        the main component, and to the first note reaching a loopback sink. Also
+        times the MIDI output scan the app now does in the background.
+    */
+    juce::var benchStartup()
+    {
+        log ("startup");
+        vmc::LookAndFeel look;
+        juce::LookAndFeel::setDefaultLookAndFeel (&look);
+
+        const int runs = scaled (40);
+        double firstFrame = 0.0, firstMidi = 0.0, maxFirstFrame = 0.0, maxFirstMidi = 0.0;
+
+        for (int i = 0; i < runs; ++i) {
+            auto start = detail::nowSeconds();
+            {
+                Controller controller (std::make_unique<NullMidiSink>(), settingsOptions());
+                MainComponent main (controller);
+                juce::Image image (juce::Image::ARGB, main.getWidth(), main.getHeight(), true);
+                juce::Graphics g (image);
+                main.paintEntireComponent (g, true);
+
+                const auto elapsed = (detail::nowSeconds() - start) * 1000.0;
+                firstFrame += elapsed;
+                maxFirstFrame = juce::jmax (maxFirstFrame, elapsed);
+            }
+
+            auto sink = std::make_unique<LoopbackMidiSink> (1);
+            auto& loopback = *sink;
+            start = detail::nowSeconds();
+            {
+                Controller controller (std::move (sink), settingsOptions());
+                controller.playNote (juce::MidiMessage::noteOn (1, 60, (juce::uint8) 100));
+                loopback.waitForMessages (1, 1000);
+
+                const auto elapsed = (detail::nowSeconds() - start) * 1000.0;
+                firstMidi += elapsed;
+                maxFirstMidi = juce::jmax (maxFirstMidi, elapsed);
+            }
+        }
+
+        const auto scanNs = detail::nanosPerRun (juce::jmax (1, runs / 4), [] (int) {
+            juce::ignoreUnused (juce::MidiOutput::getAvailableDevices());
+        });
+
+        juce::LookAndFeel::setDefaultLookAndFeel (nullptr);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("runs", runs);
+        result->setProperty ("first_frame_ms", firstFrame / runs);
+        result->setProperty ("first_frame_max_ms", maxFirstFrame);
+        result->setProperty ("first_midi_ms", firstMidi / runs);
+        result->setProperty ("first_midi_max_ms", maxFirstMidi);
+        result->setProperty ("midi_output_scan_ms", scanNs * 1.0e-6);
+        return result;
+    }
+
+    /** Renders the preview synth with all voices sounding, as a share of one core. */
+    juce::var benchSynth()
+    {
+        log ("synth");
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 256;
+        const int numBlocks = scaled (4000);
+
+        PreviewSynth synth;
+        synth.setPlayConfigDetails (0, 2, sampleRate, blockSize);
+        synth.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        for (int i = 0; i < PreviewSynth::numVoices; ++i)
+            midi.addEvent (juce::MidiMessage::noteOn (1, 24 + i, (juce::uint8) 100), i);
+        synth.processBlock (buffer, midi);
+        midi.clear();
+
+        // Sweep the filter now and then, as a dial would.
+        const auto blockNs = detail::nanosPerRun (numBlocks, [&] (int i) {
+            if (i % 16 == 0)
+                midi.addEvent (juce::MidiMessage::controllerEvent (1, 74, i % 128), 0);
+            synth.processBlock (buffer, midi);
+            midi.clear();
+        });
+
+        const auto realTimeNs = blockSize / sampleRate * 1.0e9;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("voices", synth.getNumActiveVoices());
+        result->setProperty ("lanes", PreviewSynth::numLanes);
+        result->setProperty ("block_size", blockSize);
+        result->setProperty ("block_us", blockNs * 1.0e-3);
+        result->setProperty ("core_percent", blockNs / realTimeNs * 100.0);
+        return result;
+    }
+
+    /** Leaves the controller idle with the audio device open, then MIDI only,
+        and compares the CPU used and the context switches per second. Each
+        context switch is a thread waking up. Not measured on Windows.
+    */
+    juce::var benchIdle()
+    {
+        log ("idle");
+        const int millis = quick ? 1000 : 10000;
+
+        const auto measure = [this, millis] (bool midiOnly) {
+            Controller controller (std::make_unique<NullMidiSink>(), settingsOptions());
+            controller.setMidiOnly (midiOnly);
+            controller.initializeAudioDevice();
+
+            auto* device = controller.getDeviceManager().getCurrentAudioDevice();
+            const auto deviceName = device != nullptr ? device->getName() : juce::String();
+            const int bufferSize = device != nullptr ? device->getCurrentBufferSizeSamples() : 0;
+
+            // Let the device settle before counting.
+            juce::Thread::sleep (500);
+            const auto before = detail::getProcessUsage();
+            const auto start = detail::nowSeconds();
+            juce::Thread::sleep (millis);
+            const auto after = detail::getProcessUsage();
+            const auto elapsed = detail::nowSeconds() - start;
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("audio_device", deviceName);
+            result->setProperty ("buffer_size", bufferSize);
+            result->setProperty ("cpu_percent", (after.cpuSeconds - before.cpuSeconds) / elapsed * 100.0);
+            result->setProperty ("wakeups_per_second", (double) (after.contextSwitches - before.contextSwitches) / elapsed);
+            return juce::var (result);
+        };
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("seconds", millis / 1000);
+        result->setProperty ("audio", measure (false));
+        result->setProperty ("midi_only", measure (true));
+        return result;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Bench)
+};
+
+} // namespace vmc
+
+int main (int argc, char* argv[])
+{
+    const juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h")) {
+        std::cout << vmc::detail::benchHelp << std::endl;
+        return 0;
+    }
+
+    const juce::ScopedJuceInitialiser_GUI gui;
+
+    juce::StringArray only;
+    if (args.containsOption ("--only"))
+        only = juce::StringArray::fromTokens (args.getValueForOption ("--only"), ",", {});
+
+    vmc::Bench bench (args.containsOption ("--quick"));
+    const auto json = juce::JSON::toString (bench.run (only));
+
+    if (args.containsOption ("--output")) {
+        const auto path = args.getValueForOption ("--output").unquoted();
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (path);
+        if (! file.replaceWithText (json + "\n")) {
+            std::cerr << "vmc-bench: could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    std::cout << json << std::endl;
+    return 0;
+}
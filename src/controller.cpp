@@ -3,125 +3,374 @@
 
 #include "controller.hpp"
 #include "device.hpp"
+#include "engine.hpp"
+#include "latencytracer.hpp"
+#include "librarian.hpp"
+#include "mididispatcher.hpp"
+#include "midisender.hpp"
+#include "midisink.hpp"
+#include "oscserver.hpp"
+#include "pluginscanner.hpp"
+#include "sampleplayer.hpp"
+#include "sharedmidiring.hpp"
+#include "stallwatchdog.hpp"
+#include "stressgenerator.hpp"
+#include "sysexdump.hpp"
+#include "tracing.hpp"
 
 using juce::File;
 using juce::String;
 
 namespace vmc {
+namespace detail {
+/** How often in milliseconds the chain output is checked, the audio thread doesn't wake it. */
+static constexpr int chainPollInterval = 1;
 
-/** Listens to Device ValueTree data and generates MIDI messages when values change. */
-class MidiDispatcher : public juce::ValueTree::Listener {
+/** Runs a function once on a background thread. */
+class BackgroundTask final : public juce::Thread {
 public:
-    /** Callback function type for receiving generated MIDI messages. */
-    using MidiCallback = std::function<void (const MidiMessage&)>;
+    BackgroundTask (const juce::String& name, std::function<void()> fn)
+        : juce::Thread (name), function (std::move (fn)) {}
 
-    MidiDispatcher() = default;
-    ~MidiDispatcher() override { detach(); }
+    ~BackgroundTask() override { stopThread (10000); }
 
-    /** Attaches the dispatcher to a Device's data and starts listening for changes.
-        @param device The device to monitor for changes.
-        @param callback The callback function to invoke when MIDI messages are generated.
-    */
-    void attach (Device& device, MidiCallback callback)
+private:
+    std::function<void()> function;
+    void run() override { function(); }
+};
+} // namespace detail
+
+struct Controller::Impl : public MidiKeyboardStateListener {
+    Impl (Controller& c)
+        : owner (c),
+          dumpSender ([this] (const MidiMessage& msg) { owner.addMidiMessage (msg); }),
+          librarian ([this] (const MidiMessage& msg) { owner.addMidiMessage (msg); }),
+          sender ([this] (const MidiMessage& msg) { sendNow (msg); }),
+          chainSender ([this] (const MidiMessage& msg) { sendToSink (msg); }, 8192, detail::chainPollInterval)
+    {
+        selfRef = this;
+        dumpReceiver.onDumpReceived = [this] (juce::ValueTree state) {
+            // Received on the MIDI thread, apply it in one go on the message thread.
+            juce::MessageManager::callAsync ([ref = selfRef, state]() {
+                if (auto* self = ref.get())
+                    self->applyDeviceState (state);
+            });
+        };
+    }
+
+    ~Impl()
     {
-        detach();
-        _data = device.data();
-        _midiCallback = std::move (callback);
-        _data.addListener (this);
+        dumpSender.cancel();
     }
 
-    /** Detaches from the current device and stops listening. */
-    void detach()
+    Controller& owner;
+    Settings settings;
+    OptionalScopedPointer<AudioDeviceManager> audioDeviceManager;
+    MidiKeyboardState keyboardState;
+    juce::String virtualDeviceName { "VMC-MIDI-Out" };
+    Device device;
+    juce::File deviceFile;
+    ListenerList<Controller::Listener> listeners;
+    MidiDispatcher dispatch;
+    SysExSender dumpSender;
+    SysExDumpReceiver dumpReceiver;
+    SysExLibrarian librarian;
+    juce::WeakReference<Impl> selfRef;
+    bool audioInitialized = false;
+    bool keyboardMuted = false;
+    std::unique_ptr<OscServer> osc;
+    juce::CriticalSection outputLock;
+    std::unique_ptr<MidiSink> sink;
+    Engine engine;
+    LatencyTracer tracer;
+    std::unique_ptr<SharedMidiRing> ring;
+    MidiSender sender;
+    // Sends what comes out of the plugin chain, queued from the audio thread.
+    MidiSender chainSender;
+    juce::AudioPluginFormatManager pluginFormats;
+    juce::KnownPluginList knownPlugins;
+    PluginScanner pluginScanner { pluginFormats, knownPlugins };
+    // The saved chain, loaded once the engine has been prepared by the device.
+    std::unique_ptr<juce::XmlElement> pendingChain;
+    bool pluginsPrepared = false;
+    StressGenerator stress { sender };
+    StallWatchdog watchdog { sender };
+    std::atomic<bool> devicesReady { false }, midiOnly { false };
+    juce::Array<juce::MidiDeviceInfo> midiOutputs;
+    juce::CriticalSection midiOutputsLock;
+    juce::MidiDeviceListConnection midiDeviceConnection;
+    // The output the user chose, kept while it is unplugged so it can be reopened.
+    juce::String requestedOutput;
+    // Last, so it is joined before anything it touches is destroyed.
+    std::unique_ptr<detail::BackgroundTask> deviceTask;
+
+    void sendNow (const MidiMessage& msg)
     {
-        if (_data.isValid())
-            _data.removeListener (this);
-        _data = juce::ValueTree();
-        _midiCallback = nullptr;
+        VMC_TRACE_SCOPE ("Controller::sendNow");
+        // With plugins in the chain, the engine sends what comes out of them instead.
+        if (engine.addMidiMessage (msg) && engine.hasPlugins())
+            return;
+        sendToSink (msg);
     }
 
-    /** Returns true if currently attached to a device. */
-    bool isAttached() const noexcept { return _data.isValid() && _midiCallback != nullptr; }
+    void sendToSink (const MidiMessage& msg)
+    {
+        const juce::ScopedLock sl (outputLock);
+        if (sink != nullptr)
+            sink->send (msg);
+    }
 
-private:
-    juce::ValueTree _data;
-    MidiCallback _midiCallback;
+    juce::AudioPluginInstance* addPlugin (const juce::PluginDescription& description, juce::String& error)
+    {
+        auto instance = pluginFormats.createPluginInstance (description, engine.getSampleRate(), engine.getBlockSize(), error);
+        if (instance == nullptr)
+            return nullptr;
+
+        // Instruments and audio effects would swallow the MIDI they are sent.
+        if (! instance->producesMidi()) {
+            error = description.name + " doesn't produce MIDI, only MIDI plugins can go in the chain";
+            return nullptr;
+        }
 
-    void sendMidiMessage (const MidiMessage& msg)
+        auto* plugin = instance.get();
+        if (engine.addPlugin (std::move (instance)) == Engine::NodeID()) {
+            error = "Could not add " + description.name + " to the chain";
+            return nullptr;
+        }
+        // Only polls while there is a chain.
+        chainSender.start();
+        return plugin;
+    }
+
+    std::unique_ptr<juce::XmlElement> createPluginChainXml()
     {
-        if (_midiCallback)
-            _midiCallback (msg);
+        auto chain = std::make_unique<juce::XmlElement> ("PLUGINCHAIN");
+        for (int i = 0; i < engine.getNumPlugins(); ++i) {
+            if (auto* plugin = engine.getPlugin (i)) {
+                auto* element = chain->createNewChildElement ("PLUGIN");
+                element->addChildElement (plugin->getPluginDescription().createXml().release());
+                juce::MemoryBlock state;
+                plugin->getStateInformation (state);
+                element->setAttribute ("state", state.toBase64Encoding());
+            }
+        }
+        return chain;
     }
 
-    int getMidiChannel() const noexcept
+    void restorePluginChain (const juce::XmlElement& chain)
     {
-        return _data.getProperty (Device::midiChannelID, 1);
+        for (auto* element : chain.getChildWithTagNameIterator ("PLUGIN")) {
+            juce::PluginDescription description;
+            auto* descriptionXml = element->getFirstChildElement();
+            if (descriptionXml == nullptr || ! description.loadFromXml (*descriptionXml))
+                continue;
+
+            juce::String error;
+            if (auto* plugin = addPlugin (description, error)) {
+                juce::MemoryBlock state;
+                if (state.fromBase64Encoding (element->getStringAttribute ("state")) && state.getSize() > 0)
+                    plugin->setStateInformation (state.getData(), (int) state.getSize());
+            } else {
+                DBG ("[vmc] could not load " << description.name << ": " << error);
+            }
+        }
     }
 
-    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override
+    /** Registers the plugin formats and reads the scan cache, the first time
+        plugins are needed. Headless and MIDI only runs never pay for it.
+    */
+    void preparePlugins()
     {
-        if (! _midiCallback)
+        if (pluginsPrepared)
             return;
+        pluginsPrepared = true;
+        pluginFormats.addDefaultFormats();
+        pluginScanner.loadCache();
+    }
 
-        // Handle device-level property changes
-        if (tree == _data) {
-            if (property == Device::midiProgramID) {
-                int program = static_cast<int> (tree.getProperty (property)) - 1; // MIDI programs are 0-127
-                program = juce::jlimit (0, 127, program);
-                sendMidiMessage (MidiMessage::programChange (getMidiChannel(), program));
-            }
+    /** Loads the saved chain on the message thread once the audio device is
+        open, so the graph isn't changed while the device thread prepares it.
+        MIDI only the chain is bypassed, it stays saved until audio opens.
+    */
+    void restorePendingChain()
+    {
+        if (pendingChain == nullptr || ! devicesReady.load() || ! audioInitialized)
             return;
+        const auto chain = std::move (pendingChain);
+        preparePlugins();
+        restorePluginChain (*chain);
+    }
+
+    /** Does what only matters with sound, once the audio device is open. */
+    void audioOpened()
+    {
+        restorePendingChain();
+        auto& player = engine.getSamplePlayer();
+        if (engine.getInstrument() == Engine::samplePlayer && player.getFolder() == File())
+            player.loadFolder (Controller::getSamplesPath());
+    }
+
+    void openAudioDevice()
+    {
+        auto& devices = owner.getDeviceManager();
+        bool initDefault = true;
+
+        // The default MIDI output may be replaced, keep the sender thread away from it.
+        const juce::ScopedLock sl (outputLock);
+
+        if (auto* const props = settings.getUserSettings()) {
+            if (auto xml = props->getXmlValue ("devices")) {
+                initDefault = devices.initialise (32, 32, xml.get(), false).isNotEmpty();
+                requestedOutput = xml->getStringAttribute ("defaultMidiOutputDevice");
+            }
         }
 
-        // Handle dial/fader value changes (Ranged children)
-        if (tree.getType() == Device::RangedID && property == Device::valueID) {
-            auto parent = tree.getParent();
-            if (parent.isValid() && (parent.getType() == Device::dialsID || parent.getType() == Device::fadersID)) {
-                int ccNumber = tree.getProperty (Device::ccNumberID, 0);
-                int value = static_cast<int> (tree.getProperty (Device::valueID));
-                value = juce::jlimit (0, 127, value);
-                sendMidiMessage (MidiMessage::controllerEvent (getMidiChannel(), ccNumber, value));
+        if (initDefault) {
+            devices.initialiseWithDefaultDevices (32, 32);
+        }
+
+        devices.addAudioCallback (&owner);
+        audioInitialized = true;
+    }
+
+    /** Restores only the MIDI part of the saved setup, no audio device is opened. */
+    void openMidiDevices()
+    {
+        auto& devices = owner.getDeviceManager();
+
+        if (auto* const props = settings.getUserSettings()) {
+            if (auto xml = props->getXmlValue ("devices")) {
+                for (auto* input : xml->getChildWithTagNameIterator ("MIDIINPUT"))
+                    devices.setMidiInputDeviceEnabled (input->getStringAttribute ("identifier"), true);
+                requestedOutput = xml->getStringAttribute ("defaultMidiOutputDevice");
+                reopenOutput (requestedOutput);
             }
         }
     }
 
-    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override {}
-    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override {}
-    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override {}
-    void valueTreeParentChanged (juce::ValueTree&) override {}
-    void valueTreeRedirected (juce::ValueTree&) override {}
-};
+    void openDevices()
+    {
+        if (midiOnly.load())
+            openMidiDevices();
+        else
+            openAudioDevice();
+        owner.getDeviceManager().addMidiInputDeviceCallback (String(), &owner);
+    }
 
-struct Controller::Impl : public MidiKeyboardStateListener {
-    Impl (Controller& c) : owner (c) {}
-    ~Impl() {}
+    /** Stops the audio callbacks and releases the sound card, keeping MIDI open. */
+    void closeAudioDevice()
+    {
+        if (! audioInitialized)
+            return;
 
-    Controller& owner;
-    Settings settings;
-    OptionalScopedPointer<AudioDeviceManager> audioDeviceManager;
-    std::unique_ptr<MidiOutput> midiOut;
-    MidiKeyboardState keyboardState;
-    juce::String virtualDeviceName { "VMC-MIDI-Out" };
-    Device device;
-    juce::File deviceFile;
-    ListenerList<Controller::Listener> listeners;
-    MidiDispatcher dispatch;
+        // Keep the audio setup for when the device is opened again.
+        saveSettings();
+        auto& devices = owner.getDeviceManager();
+        devices.removeAudioCallback (&owner);
+        devices.closeAudioDevice();
+        audioInitialized = false;
+    }
+
+    void scanMidiOutputs()
+    {
+        VMC_TRACE_SCOPE ("Controller::scanMidiOutputs");
+        auto outputs = juce::MidiOutput::getAvailableDevices();
+        const juce::ScopedLock sl (midiOutputsLock);
+        midiOutputs.swapWith (outputs);
+    }
+
+    void devicesOpened()
+    {
+        deviceTask.reset();
+        devicesReady = true;
+        midiDeviceConnection = juce::MidiDeviceListConnection::make ([this]() { midiDevicesChanged(); });
+        if (audioInitialized)
+            audioOpened();
+        listeners.call (&Controller::Listener::devicesReady);
+    }
+
+    /** Applies what was plugged in or out to the cached outputs, and reopens
+        the chosen output when it comes back.
+    */
+    void midiDevicesChanged()
+    {
+        VMC_TRACE_SCOPE ("Controller::midiDevicesChanged");
+        const auto current = juce::MidiOutput::getAvailableDevices();
+        juce::Array<juce::MidiDeviceInfo> added, removed;
+
+        {
+            const juce::ScopedLock sl (midiOutputsLock);
+            for (const auto& info : midiOutputs)
+                if (! current.contains (info))
+                    removed.add (info);
+            for (const auto& info : current)
+                if (! midiOutputs.contains (info))
+                    added.add (info);
+
+            // Existing entries keep their place, new ones go on the end.
+            for (const auto& info : removed)
+                midiOutputs.removeFirstMatchingValue (info);
+            midiOutputs.addArray (added);
+        }
+
+        if (added.isEmpty() && removed.isEmpty())
+            return;
+
+        for (const auto& info : removed)
+            if (info.identifier == requestedOutput)
+                reopenOutput ({});
+        for (const auto& info : added)
+            if (info.identifier == requestedOutput)
+                reopenOutput (requestedOutput);
+
+        listeners.call ([&added, &removed] (Controller::Listener& l) { l.midiOutputsChanged (added, removed); });
+    }
+
+    /** Closes the default output and opens it again, even if the identifier is
+        unchanged, as a port that was unplugged can't be written to.
+    */
+    void reopenOutput (const juce::String& identifier)
+    {
+        auto& devices = owner.getDeviceManager();
+        const juce::ScopedLock sl (outputLock);
+        devices.setDefaultMidiOutputDevice ({});
+        if (identifier.isNotEmpty())
+            devices.setDefaultMidiOutputDevice (identifier);
+    }
 
     void saveSettings()
     {
         auto& devices = owner.getDeviceManager();
 
         if (auto* const props = settings.getUserSettings()) {
-            if (auto devicesXml = devices.createStateXml()) {
+            // The chosen output is saved even if it is unplugged right now.
+            if (audioInitialized) {
+                if (auto devicesXml = devices.createStateXml()) {
+                    devicesXml->setAttribute ("defaultMidiOutputDevice", requestedOutput);
+                    props->setValue ("devices", devicesXml.get());
+                }
+            } else if (auto devicesXml = props->getXmlValue ("devices")) {
+                // Without an audio device only the MIDI output may have changed,
+                // keep the rest of the saved setup intact.
+                devicesXml->setAttribute ("defaultMidiOutputDevice", requestedOutput);
                 props->setValue ("devices", devicesXml.get());
             }
             if (deviceFile != File() && deviceFile.existsAsFile())
                 props->setValue ("lastDeviceFile", deviceFile.getFullPathName());
+            // A chain that hasn't been loaded yet is kept as it was.
+            if (pendingChain != nullptr)
+                props->setValue ("pluginChain", pendingChain.get());
+            else if (auto chain = createPluginChainXml())
+                props->setValue ("pluginChain", chain.get());
         }
     }
 
     void restoreSettings()
     {
         if (auto* props = settings.getUserSettings()) {
+            pendingChain = props->getXmlValue ("pluginChain");
+            restorePendingChain();
+
             const auto path = props->getValue ("lastDeviceFile");
             if (File::isAbsolutePath (path)) {
                 auto fileToLoad = File (path);
@@ -134,6 +383,7 @@ struct Controller::Impl : public MidiKeyboardStateListener {
 
     bool loadDeviceFile (const juce::File& file)
     {
+        VMC_TRACE_SCOPE ("Controller::loadDeviceFile");
         if (device.load (file)) {
             deviceFile = file;
             listeners.call (&Controller::Listener::deviceChanged);
@@ -145,67 +395,205 @@ struct Controller::Impl : public MidiKeyboardStateListener {
         return false;
     }
 
-    void init()
+    void applyDeviceState (const juce::ValueTree& state)
+    {
+        VMC_TRACE_SCOPE ("Controller::applyDeviceState");
+        if (! state.hasType (device.data().getType()))
+            return;
+
+        // Detach so replacing the tree doesn't spray MIDI for every property.
+        dispatch.detach();
+        device.load (state);
+        dispatch.attach (device, [this] (const MidiMessage& msg) {
+            owner.addMidiMessage (msg);
+        });
+        listeners.call (&Controller::Listener::deviceChanged);
+    }
+
+    bool sendDeviceDump()
+    {
+        dumpSender.setBytesPerSecond (settings.getInt (Settings::sysexBytesPerSecond, 3125));
+        return dumpSender.send (SysExDump::createPackets (device.data()));
+    }
+
+    void init (std::unique_ptr<MidiSink> newSink)
     {
         audioDeviceManager.setOwned (new AudioDeviceManager());
-#if JUCE_MAC || JUCE_LINUX
-        midiOut = MidiOutput::createNewDevice (virtualDeviceName);
-        if (midiOut != nullptr)
-            midiOut->startBackgroundThread();
-#endif
+        sink = newSink != nullptr ? std::move (newSink)
+                                  : std::make_unique<MidiPortSink> (*audioDeviceManager, virtualDeviceName);
+        engine.setMonitoring (settings.getInt (Settings::localMonitor, 0) != 0);
+        // The samples load once there is an audio device to play them.
+        if (settings.getInt (Settings::monitorSamples, 0) != 0)
+            engine.setInstrument (Engine::samplePlayer);
         keyboardState.addListener (this);
+        engine.setChainOutput (&chainSender);
+        sender.start();
     }
 
     void shutdown()
     {
+        deviceTask.reset();
+        midiDeviceConnection = {};
+        watchdog.stop();
+        osc.reset();
+        stress.stop();
+        dumpSender.cancel();
+        librarian.stopRecording();
+        librarian.getSender().cancel();
         dispatch.detach();
         if (deviceFile != File() && deviceFile.existsAsFile())
             device.save (deviceFile);
+        pluginScanner.stop();
+        sender.stop();
+        chainSender.stop();
     }
 
     void handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override
     {
+        if (keyboardMuted)
+            return;
+        const ScopedLatencyTrace trace (tracer);
         owner.addMidiMessage (MidiMessage::noteOn (midiChannel, midiNoteNumber, velocity));
     }
 
     void handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override
     {
+        if (keyboardMuted)
+            return;
+        const ScopedLatencyTrace trace (tracer);
         owner.addMidiMessage (MidiMessage::noteOff (midiChannel, midiNoteNumber, velocity));
     }
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Impl)
 };
 
 Controller::Controller()
+    : Controller (nullptr)
+{
+}
+
+Controller::Controller (std::unique_ptr<MidiSink> sink)
+    : Controller (std::move (sink), Settings::getDefaultOptions())
+{
+}
+
+Controller::Controller (std::unique_ptr<MidiSink> sink, const PropertiesFile::Options& settingsOptions)
 {
     impl.reset (new Impl (*this));
-    impl->init();
+    impl->settings.setStorageParameters (settingsOptions);
+    impl->init (std::move (sink));
 }
 
 Controller::~Controller()
 {
+    impl->deviceTask.reset();
+
+    // Stop the callbacks before what they use goes, if shutdown() wasn't called.
+    auto& devices = getDeviceManager();
+    devices.removeAudioCallback (this);
+    devices.removeMidiInputDeviceCallback (String(), this);
+    devices.closeAudioDevice();
+
+    impl->osc.reset();
+    impl->stress.stop();
+    impl->pluginScanner.stop();
+    impl->sender.stop();
+    impl->engine.setChainOutput (nullptr);
+    impl->chainSender.stop();
     impl->keyboardState.removeListener (impl.get());
-    if (impl->midiOut != nullptr)
-        impl->midiOut->stopBackgroundThread();
     impl.reset();
 }
 
 void Controller::initializeAudioDevice()
 {
-    auto& devices = getDeviceManager();
-    auto& settings = impl->settings;
-    bool initDefault = true;
+    impl->openDevices();
+    impl->scanMidiOutputs();
+    impl->devicesOpened();
+}
 
-    if (auto* const props = settings.getUserSettings()) {
-        if (auto xml = props->getXmlValue ("devices")) {
-            initDefault = devices.initialise (32, 32, xml.get(), false).isNotEmpty();
+void Controller::initializeAudioDeviceAsync()
+{
+#if JUCE_WINDOWS
+    // WASAPI and DirectSound watch for device changes with hidden windows that
+    // must belong to the message thread. Open them there, after the first frame.
+    juce::MessageManager::callAsync ([ref = impl->selfRef]() {
+        if (auto* self = ref.get()) {
+            self->openDevices();
+            self->scanMidiOutputs();
+            self->devicesOpened();
         }
-    }
+    });
+#else
+    auto* self = impl.get();
+    self->deviceTask = std::make_unique<detail::BackgroundTask> ("VMC Device Init", [self]() {
+        self->openDevices();
+        self->scanMidiOutputs();
+        juce::MessageManager::callAsync ([ref = self->selfRef]() {
+            if (auto* opened = ref.get())
+                opened->devicesOpened();
+        });
+    });
+    self->deviceTask->startThread();
+#endif
+}
 
-    if (initDefault) {
-        devices.initialiseWithDefaultDevices (32, 32);
+void Controller::initializeMidiDevices()
+{
+    impl->midiOnly = true;
+    impl->openDevices();
+    impl->scanMidiOutputs();
+    impl->devicesOpened();
+}
+
+void Controller::setMidiOnly (bool shouldBeMidiOnly)
+{
+    if (impl->midiOnly.exchange (shouldBeMidiOnly) == shouldBeMidiOnly || ! impl->devicesReady.load())
+        return;
+
+    if (shouldBeMidiOnly) {
+        impl->closeAudioDevice();
+    } else {
+        impl->openAudioDevice();
+        impl->audioOpened();
     }
+}
+
+bool Controller::isMidiOnly() const noexcept { return impl->midiOnly.load(); }
 
-    devices.addAudioCallback (this);
-    devices.addMidiInputDeviceCallback (String(), this);
+juce::KnownPluginList& Controller::getKnownPlugins()
+{
+    impl->preparePlugins();
+    return impl->knownPlugins;
+}
+
+PluginScanner& Controller::getPluginScanner()
+{
+    impl->preparePlugins();
+    return impl->pluginScanner;
+}
+
+juce::String Controller::addPlugin (const juce::PluginDescription& description)
+{
+    impl->preparePlugins();
+    juce::String error;
+    if (impl->addPlugin (description, error) == nullptr && error.isEmpty())
+        error = "Could not load " + description.name;
+    return error;
+}
+
+void Controller::removePlugin (int index)
+{
+    impl->engine.removePlugin (index);
+    if (! impl->engine.hasPlugins())
+        impl->chainSender.stop();
+}
+
+bool Controller::areDevicesReady() const noexcept { return impl->devicesReady.load(); }
+
+juce::Array<juce::MidiDeviceInfo> Controller::getMidiOutputs() const
+{
+    const juce::ScopedLock sl (impl->midiOutputsLock);
+    return impl->midiOutputs;
 }
 
 void Controller::shutdown()
@@ -217,7 +605,13 @@ void Controller::shutdown()
     devices.closeAudioDevice();
 }
 
-void Controller::saveSettings() { impl->saveSettings(); }
+void Controller::saveSettings()
+{
+    // Wait for the devices, their setup is saved too.
+    impl->deviceTask.reset();
+    impl->saveSettings();
+}
+
 void Controller::restoreSettings() { impl->restoreSettings(); }
 
 File Controller::getUserDataPath()
@@ -237,6 +631,16 @@ File Controller::getSamplesPath()
 }
 
 MidiKeyboardState& Controller::getMidiKeyboardState() { return impl->keyboardState; }
+
+void Controller::playNote (const MidiMessage& msg)
+{
+    VMC_TRACE_SCOPE ("Controller::playNote");
+    impl->sender.add (msg);
+
+    // Display only, the note has been queued already.
+    const juce::ScopedValueSetter<bool> muted (impl->keyboardMuted, true);
+    impl->keyboardState.processNextMidiEvent (msg);
+}
 Device Controller::device() const { return impl->device; }
 bool Controller::loadDeviceFile (const juce::File& file) { return impl->loadDeviceFile (file); }
 File Controller::deviceFile() const noexcept { return impl->deviceFile; }
@@ -244,14 +648,102 @@ File Controller::deviceFile() const noexcept { return impl->deviceFile; }
 Settings& Controller::getSettings() { return impl->settings; }
 AudioDeviceManager& Controller::getDeviceManager() { return *impl->audioDeviceManager; }
 
+void Controller::setMidiSink (std::unique_ptr<MidiSink> newSink)
+{
+    jassert (newSink != nullptr);
+    // Swap under the output lock and destroy the old sink after releasing it.
+    {
+        const juce::ScopedLock sl (impl->outputLock);
+        std::swap (impl->sink, newSink);
+    }
+    newSink.reset();
+}
+
+MidiSink& Controller::getMidiSink()
+{
+    return *impl->sink;
+}
+
+void Controller::setDefaultMidiOutput (const String& identifier)
+{
+    impl->requestedOutput = identifier;
+    const juce::ScopedLock sl (impl->outputLock);
+    getDeviceManager().setDefaultMidiOutputDevice (identifier);
+}
+
+void Controller::updateDeviceWithoutMidi (const std::function<void (Device&)>& update)
+{
+    impl->dispatch.setMuted (true);
+    update (impl->device);
+    impl->dispatch.setMuted (false);
+}
+
 void Controller::addMidiMessage (const MidiMessage msg)
 {
-    // std::cout << msg.getDescription() << std::endl;
+    VMC_TRACE_SCOPE ("Controller::addMidiMessage");
+    impl->sender.add (msg);
+}
 
-    if (impl->midiOut)
-        impl->midiOut->sendMessageNow (msg);
-    if (auto* const dout = impl->audioDeviceManager->getDefaultMidiOutput())
-        dout->sendMessageNow (msg);
+void Controller::addMidiBuffer (const MidiBuffer& buffer)
+{
+    VMC_TRACE_SCOPE ("Controller::addMidiBuffer");
+    impl->sender.add (buffer);
+}
+
+MidiSender& Controller::getMidiSender() { return impl->sender; }
+LatencyTracer& Controller::getLatencyTracer() { return impl->tracer; }
+StressGenerator& Controller::getStressGenerator() { return impl->stress; }
+StallWatchdog& Controller::getStallWatchdog() { return impl->watchdog; }
+Engine& Controller::getEngine() { return impl->engine; }
+
+bool Controller::startOscServer (int port)
+{
+    impl->osc = std::make_unique<OscServer> (*this);
+    if (! impl->osc->start (port)) {
+        impl->osc.reset();
+        return false;
+    }
+    return true;
+}
+
+void Controller::stopOscServer() { impl->osc.reset(); }
+OscServer* Controller::getOscServer() const noexcept { return impl->osc.get(); }
+
+bool Controller::openSharedMidiRing (const String& name)
+{
+    closeSharedMidiRing();
+    impl->ring = SharedMidiRing::create (name);
+    if (impl->ring == nullptr)
+        return false;
+    impl->sender.setSharedRing (impl->ring.get());
+    return true;
+}
+
+void Controller::closeSharedMidiRing()
+{
+    if (impl->ring == nullptr)
+        return;
+    impl->sender.setSharedRing (nullptr);
+    impl->ring.reset();
+}
+
+SharedMidiRing* Controller::getSharedMidiRing() const noexcept { return impl->ring.get(); }
+
+bool Controller::sendDeviceDump() { return impl->sendDeviceDump(); }
+bool Controller::isSendingDeviceDump() const noexcept { return impl->dumpSender.isSending(); }
+SysExLibrarian& Controller::getLibrarian() { return impl->librarian; }
+
+void Controller::handleIncomingMidiMessage (MidiInput*, const MidiMessage& msg)
+{
+    VMC_TRACE_SCOPE ("Controller::handleIncomingMidiMessage");
+    impl->dumpReceiver.handleMessage (msg);
+}
+
+void Controller::handlePartialSysexMessage (MidiInput*, const uint8* messageData,
+                                            int numBytesSoFar, double)
+{
+    VMC_TRACE_SCOPE ("Controller::handlePartialSysexMessage");
+    impl->dumpReceiver.handlePartialSysex (messageData, numBytesSoFar);
 }
 
 void Controller::audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
@@ -261,11 +753,12 @@ void Controller::audioDeviceIOCallbackWithContext (const float* const* inputChan
                                                    int numSamples,
                                                    const AudioIODeviceCallbackContext& context)
 {
-    juce::ignoreUnused (inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples, context);
+    impl->engine.audioDeviceIOCallbackWithContext (inputChannelData, numInputChannels, outputChannelData,
+                                                   numOutputChannels, numSamples, context);
 }
 
-void Controller::audioDeviceAboutToStart (AudioIODevice*) {}
-void Controller::audioDeviceStopped() {}
+void Controller::audioDeviceAboutToStart (AudioIODevice* device) { impl->engine.audioDeviceAboutToStart (device); }
+void Controller::audioDeviceStopped() { impl->engine.audioDeviceStopped(); }
 void Controller::audioDeviceError (const String& errorMessage) { juce::ignoreUnused (errorMessage); }
 
 void Controller::addListener (Listener* listener) { impl->listeners.add (listener); }
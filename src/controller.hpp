@@ -6,19 +6,49 @@
 #include "juce.hpp"
 #include "settings.hpp"
 
+namespace juce {
+class KnownPluginList;
+class PluginDescription;
+} // namespace juce
+
 namespace vmc {
 
 class Device;
+class Engine;
+class LatencyTracer;
+class MidiSender;
+class MidiSink;
+class OscServer;
+class PluginScanner;
+class SharedMidiRing;
+class StallWatchdog;
+class StressGenerator;
+class SysExLibrarian;
 
 class Controller final : public AudioIODeviceCallback,
                          public MidiInputCallback {
 public:
+    /** Creates a controller that sends to MIDI ports. */
     Controller();
+    /** Creates a controller that sends to the given sink, or to MIDI ports if null. */
+    explicit Controller (std::unique_ptr<MidiSink> sink);
+    /** Creates a controller with settings stored elsewhere than the user's,
+        see Settings::getOptionsInFolder().
+    */
+    Controller (std::unique_ptr<MidiSink> sink, const PropertiesFile::Options& settingsOptions);
     ~Controller();
 
     struct Listener {
         virtual ~Listener() = default;
         virtual void deviceChanged() = 0;
+        /** Called on the message thread once the audio and MIDI devices are open. */
+        virtual void devicesReady() {}
+        /** Called on the message thread when MIDI outputs are plugged in or out. */
+        virtual void midiOutputsChanged (const juce::Array<juce::MidiDeviceInfo>& added,
+                                         const juce::Array<juce::MidiDeviceInfo>& removed)
+        {
+            juce::ignoreUnused (added, removed);
+        }
     };
 
     Device device() const;
@@ -30,10 +60,107 @@ public:
     void saveSettings();
     void restoreSettings();
 
+    /** Replaces where outgoing MIDI goes, safely with respect to the sender thread. */
+    void setMidiSink (std::unique_ptr<MidiSink> sink);
+    /** Returns where outgoing MIDI goes. */
+    MidiSink& getMidiSink();
+
+    /** Returns true once the audio and MIDI devices have been opened. */
+    bool areDevicesReady() const noexcept;
+    /** Opens the audio and MIDI devices on the calling thread and returns
+        when they are ready, for tools without a running message loop. The app
+        opens them in the background instead. The devices are closed when the
+        controller is deleted.
+    */
+    void initializeAudioDevice();
+    /** Runs without an audio device, so nothing wakes up per audio buffer and
+        the sound card is left alone. Set before the devices open to pick how
+        they open, afterwards it closes or reopens the audio device. Call on the
+        message thread. Local monitoring is silent while MIDI only.
+    */
+    void setMidiOnly (bool shouldBeMidiOnly);
+    bool isMidiOnly() const noexcept;
+
+    /** Returns the plugins found by scans, cached between runs. The plugin
+        formats and the cache are set up on first use. Call on the message thread.
+    */
+    juce::KnownPluginList& getKnownPlugins();
+    /** Returns the scanner that fills the known plugins out of process. */
+    PluginScanner& getPluginScanner();
+
+    /** Loads a plugin at the end of the engine's MIDI chain. Returns an error
+        message, or an empty string. Plugins that don't produce MIDI are
+        refused. Call on the message thread. The chain is saved with the
+        settings.
+    */
+    juce::String addPlugin (const juce::PluginDescription& description);
+    /** Takes a plugin out of the chain. Call on the message thread. */
+    void removePlugin (int index);
+
+    /** Returns the MIDI outputs, kept up to date as devices are plugged in and out. */
+    juce::Array<juce::MidiDeviceInfo> getMidiOutputs() const;
+
+    /** Changes the default MIDI output, safely with respect to the sender thread.
+        If the output is unplugged later, it is reopened when it comes back.
+    */
+    void setDefaultMidiOutput (const String& identifier);
+
+    /** Applies changes to the device model without generating MIDI. Use this to
+        reflect values that have already been sent.
+    */
+    void updateDeviceWithoutMidi (const std::function<void (Device&)>& update);
+
     //=========================================================================
+    /** Queues a message for output. Safe to call from any thread. */
     void addMidiMessage (const MidiMessage msg);
+    /** Queues all messages in a buffer to go out back to back. Safe to call from any thread. */
+    void addMidiBuffer (const MidiBuffer& buffer);
+    MidiSender& getMidiSender();
     MidiKeyboardState& getMidiKeyboardState();
 
+    /** Returns the generator of synthetic MIDI traffic. */
+    StressGenerator& getStressGenerator();
+
+    /** Returns the audio engine that lets outgoing MIDI be heard locally. */
+    Engine& getEngine();
+
+    /** Returns the watchdog that logs message thread stalls. */
+    StallWatchdog& getStallWatchdog();
+
+    /** Returns the tracer that follows gestures through to the MIDI output. */
+    LatencyTracer& getLatencyTracer();
+
+    /** Queues a note on or off straight away, then shows it on the keyboard
+        state without sending it a second time.
+    */
+    void playNote (const MidiMessage& noteOnOrOff);
+
+    //=========================================================================
+    /** Starts the OSC server on the given UDP port. */
+    bool startOscServer (int port);
+    /** Stops the OSC server. */
+    void stopOscServer();
+    /** Returns the OSC server if running. */
+    OscServer* getOscServer() const noexcept;
+
+    //=========================================================================
+    /** Creates a shared memory ring other processes can write MIDI into, the
+        sender thread drains it directly. POSIX only.
+    */
+    bool openSharedMidiRing (const String& name);
+    /** Removes the shared memory ring. */
+    void closeSharedMidiRing();
+    /** Returns the shared memory ring if open. */
+    SharedMidiRing* getSharedMidiRing() const noexcept;
+
+    //=========================================================================
+    /** Sends the current device state as a paced, chunked SysEx dump. */
+    bool sendDeviceDump();
+    /** Returns true while a device dump is being sent. */
+    bool isSendingDeviceDump() const noexcept;
+    /** Returns the SysEx librarian. */
+    SysExLibrarian& getLibrarian();
+
     //=========================================================================
     static File getUserDataPath();
     static File getSamplesPath();
@@ -53,9 +180,9 @@ public:
     void audioDeviceError (const String& errorMessage) override;
 
     //=========================================================================
-    virtual void handleIncomingMidiMessage (MidiInput*, const MidiMessage&) override {}
-    virtual void handlePartialSysexMessage (MidiInput*, const uint8*,
-                                            int, double) override {}
+    void handleIncomingMidiMessage (MidiInput*, const MidiMessage&) override;
+    void handlePartialSysexMessage (MidiInput*, const uint8* messageData,
+                                    int numBytesSoFar, double timestamp) override;
 
     void addListener (Listener*);
     void removeListener (Listener*);
@@ -66,7 +193,9 @@ private:
 
     //=========================================================================
     friend class Application;
-    void initializeAudioDevice();
+    /** Opens the devices in the background, listeners hear devicesReady() when done. */
+    void initializeAudioDeviceAsync();
+    void initializeMidiDevices();
     void shutdown();
 };
 
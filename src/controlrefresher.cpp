@@ -0,0 +1,123 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "controlrefresher.hpp"
+
+namespace vmc {
+
+ControlRefresher::ControlRefresher (juce::Component& component)
+    : vblank (&component, [this] { refresh(); })
+{
+}
+
+ControlRefresher::~ControlRefresher()
+{
+    unbind();
+}
+
+void ControlRefresher::bind (const Device& device,
+                             const juce::Array<juce::Slider*>& dialSliders,
+                             const juce::Array<juce::Slider*>& faderSliders)
+{
+    unbind();
+
+    data = device.data();
+    bindGroup (dials, device.dials(), dialSliders);
+    bindGroup (faders, device.faders(), faderSliders);
+    data.addListener (this);
+
+    // Show the current values straight away.
+    refresh();
+}
+
+void ControlRefresher::bindGroup (Group& group, const juce::ValueTree& tree,
+                                  const juce::Array<juce::Slider*>& sliders)
+{
+    group.tree = tree;
+    group.sliders = sliders;
+    group.dirty.assign ((size_t) sliders.size(), true);
+    anyDirty = true;
+
+    for (auto* slider : sliders)
+        slider->addListener (this);
+}
+
+void ControlRefresher::unbind()
+{
+    if (data.isValid())
+        data.removeListener (this);
+    data = {};
+
+    for (auto* group : { &dials, &faders }) {
+        for (auto* slider : group->sliders)
+            slider->removeListener (this);
+        *group = {};
+    }
+}
+
+void ControlRefresher::refresh()
+{
+    if (! anyDirty)
+        return;
+    anyDirty = false;
+    refreshGroup (dials);
+    refreshGroup (faders);
+}
+
+void ControlRefresher::refreshGroup (Group& group)
+{
+    for (int i = 0; i < group.sliders.size(); ++i) {
+        if (! group.dirty[(size_t) i])
+            continue;
+        group.dirty[(size_t) i] = false;
+
+        const auto child = group.tree.getChild (i);
+        if (! child.isValid())
+            continue;
+
+        // Repaints only this slider, and only if the value moved.
+        group.sliders.getUnchecked (i)->setValue (child.getProperty (Device::valueID, 0),
+                                                  juce::dontSendNotification);
+        ++numRefreshes;
+    }
+}
+
+void ControlRefresher::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property)
+{
+    if (property != Device::valueID)
+        return;
+
+    const auto parent = tree.getParent();
+    auto& group = parent == dials.tree ? dials : faders;
+    if (parent != group.tree)
+        return;
+
+    const int index = parent.indexOf (tree);
+    if (juce::isPositiveAndBelow (index, group.sliders.size())) {
+        group.dirty[(size_t) index] = true;
+        anyDirty = true;
+        ++numChanges;
+    }
+}
+
+void ControlRefresher::sliderValueChanged (juce::Slider* slider)
+{
+    // A traced gesture starts here, the model change is its next stage.
+    std::optional<ScopedLatencyTrace> trace;
+    if (tracer != nullptr)
+        trace.emplace (*tracer);
+
+    for (auto* group : { &dials, &faders }) {
+        const int index = group->sliders.indexOf (slider);
+        if (index >= 0) {
+            auto child = group->tree.getChild (index);
+            if (child.isValid()) {
+                LatencyTracer::mark (LatencyTracer::valueChange);
+                child.setProperty (Device::valueID, juce::roundToInt (slider->getValue()), nullptr);
+            }
+            return;
+        }
+    }
+}
+
+} // namespace vmc
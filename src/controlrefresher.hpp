@@ -0,0 +1,66 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "device.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+
+/** Keeps dial and fader sliders in step with a device, once per frame.
+
+    Model changes only mark the affected control dirty. A VBlankAttachment
+    then moves each dirty slider to the latest value, so only those sliders
+    repaint, at most once per frame, however fast values arrive. Moving a
+    slider writes straight to the model.
+*/
+class ControlRefresher final : private juce::ValueTree::Listener,
+                               private juce::Slider::Listener {
+public:
+    /** Refreshes in time with the display the component is on. */
+    explicit ControlRefresher (juce::Component& component);
+    ~ControlRefresher() override;
+
+    /** Binds sliders to the device's dials and faders by index. */
+    void bind (const Device& device,
+               const juce::Array<juce::Slider*>& dials,
+               const juce::Array<juce::Slider*>& faders);
+
+    /** Traces slider gestures through to the MIDI output, or stops if null. */
+    void setLatencyTracer (LatencyTracer* newTracer) noexcept { tracer = newTracer; }
+
+    /** Returns the number of model changes seen. */
+    juce::int64 getNumChanges() const noexcept { return numChanges; }
+    /** Returns the number of slider updates made, less than changes when coalescing. */
+    juce::int64 getNumRefreshes() const noexcept { return numRefreshes; }
+
+private:
+    struct Group {
+        juce::ValueTree tree;
+        juce::Array<juce::Slider*> sliders;
+        std::vector<bool> dirty;
+    };
+
+    juce::ValueTree data;
+    Group dials, faders;
+    bool anyDirty = false;
+    juce::int64 numChanges = 0, numRefreshes = 0;
+    LatencyTracer* tracer = nullptr;
+    juce::VBlankAttachment vblank;
+
+    void bindGroup (Group& group, const juce::ValueTree& tree, const juce::Array<juce::Slider*>& sliders);
+    void unbind();
+    void refresh();
+    void refreshGroup (Group& group);
+
+    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override;
+    void sliderValueChanged (juce::Slider* slider) override;
+
+    JUCE_DECLARE_NON_COPYABLE (ControlRefresher)
+};
+
+} // namespace vmc
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "device.hpp"
+#include "tracing.hpp"
 
 using juce::ValueTree;
 
@@ -45,9 +46,15 @@ Device::~Device()
 
 bool Device::load (const juce::File& xml)
 {
+    VMC_TRACE_SCOPE ("Device::load");
     ValueTree newData;
     if (auto xmlElement = juce::XmlDocument::parse (xml))
         newData = juce::ValueTree::fromXml (*xmlElement);
+    return load (newData);
+}
+
+bool Device::load (const juce::ValueTree& newData)
+{
     if (newData.isValid()) {
         _data.removeAllProperties (nullptr);
         _data.removeAllChildren (nullptr);
@@ -59,6 +66,7 @@ bool Device::load (const juce::File& xml)
 
 void Device::save (const juce::File& file) const
 {
+    VMC_TRACE_SCOPE ("Device::save");
     if (auto xml = _data.createXml())
         xml->writeTo (file);
 }
@@ -87,6 +87,8 @@ public:
     }
 
     bool load (const juce::File&);
+    /** Replaces this device's properties and children with those in newData. */
+    bool load (const juce::ValueTree& newData);
     void save (const juce::File&) const;
 
 private:
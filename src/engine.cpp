@@ -0,0 +1,242 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "engine.hpp"
+#include "midisender.hpp"
+#include "previewsynth.hpp"
+#include "sampleplayer.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int engineMaxBlockSize = 8192;
+static constexpr int engineBytesPerEvent = 16;
+} // namespace detail
+
+Engine::Engine (int capacity)
+    : fifo (capacity),
+      events ((size_t) capacity)
+{
+    using IO = juce::AudioProcessorGraph::AudioGraphIOProcessor;
+    graph.setPlayConfigDetails (0, 2, sampleRate.load(), 512);
+
+    midiInputNode = graph.addNode (std::make_unique<IO> (IO::midiInputNode))->nodeID;
+    midiOutputNode = graph.addNode (std::make_unique<IO> (IO::midiOutputNode))->nodeID;
+    audioOutputNode = graph.addNode (std::make_unique<IO> (IO::audioOutputNode))->nodeID;
+    instrumentNode = graph.addNode (std::make_unique<PreviewSynth>())->nodeID;
+
+    auto sampler = std::make_unique<SamplePlayer>();
+    samplePlayerProcessor = sampler.get();
+    samplerNode = graph.addNode (std::move (sampler))->nodeID;
+
+    updateMidiConnections();
+    for (int channel = 0; channel < 2; ++channel) {
+        graph.addConnection ({ { instrumentNode, channel }, { audioOutputNode, channel } });
+        graph.addConnection ({ { samplerNode, channel }, { audioOutputNode, channel } });
+    }
+}
+
+Engine::~Engine()
+{
+    graph.releaseResources();
+}
+
+void Engine::setInstrument (Instrument newInstrument)
+{
+    if (newInstrument == instrument)
+        return;
+
+    instrument = newInstrument;
+    updateMidiConnections();
+}
+
+void Engine::updateMidiConnections()
+{
+    for (const auto& connection : graph.getConnections())
+        if (connection.source.isMIDI())
+            graph.removeConnection (connection);
+
+    // Through each plugin in turn, then to the instrument and out of the graph.
+    // Only the instrument with MIDI sounds, the other one falls silent after its release.
+    const auto midi = juce::AudioProcessorGraph::midiChannelIndex;
+    auto source = midiInputNode;
+    for (const auto plugin : plugins) {
+        graph.addConnection ({ { source, midi }, { plugin, midi } });
+        source = plugin;
+    }
+
+    graph.addConnection ({ { source, midi }, { instrument == samplePlayer ? samplerNode : instrumentNode, midi } });
+    graph.addConnection ({ { source, midi }, { midiOutputNode, midi } });
+    pluginsActive = ! plugins.empty();
+}
+
+Engine::NodeID Engine::addPlugin (std::unique_ptr<juce::AudioPluginInstance> plugin)
+{
+    if (plugin == nullptr)
+        return {};
+
+    // Only the MIDI of the chain is used, the plugins' audio isn't connected.
+    auto node = graph.addNode (std::move (plugin));
+    if (node == nullptr)
+        return {};
+
+    plugins.push_back (node->nodeID);
+    updateMidiConnections();
+    return node->nodeID;
+}
+
+void Engine::removePlugin (int index)
+{
+    if (! juce::isPositiveAndBelow (index, getNumPlugins()))
+        return;
+
+    const auto nodeID = plugins[(size_t) index];
+    plugins.erase (plugins.begin() + index);
+    updateMidiConnections();
+    graph.removeNode (nodeID);
+}
+
+juce::AudioPluginInstance* Engine::getPlugin (int index) const
+{
+    if (! juce::isPositiveAndBelow (index, getNumPlugins()))
+        return nullptr;
+    if (auto node = graph.getNodeForId (plugins[(size_t) index]))
+        return dynamic_cast<juce::AudioPluginInstance*> (node->getProcessor());
+    return nullptr;
+}
+
+bool Engine::addMidiMessage (const juce::MidiMessage& message)
+{
+    const int size = message.getRawDataSize();
+    const bool wanted = monitoring.load (std::memory_order_relaxed) || pluginsActive.load (std::memory_order_relaxed);
+    if (! wanted || ! running.load (std::memory_order_relaxed) || message.isSysEx() || size > 3)
+        return false;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (writeLock);
+        const auto scope = fifo.write (1);
+        if (scope.blockSize1 + scope.blockSize2 < 1) {
+            ++numDropped;
+            return false;
+        }
+
+        auto& event = events[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        std::copy (message.getRawData(), message.getRawData() + size, event.data);
+        event.size = (juce::uint8) size;
+        event.time = juce::Time::getMillisecondCounterHiRes();
+    }
+
+    return true;
+}
+
+void Engine::audioDeviceAboutToStart (juce::AudioIODevice* device)
+{
+    const auto rate = device->getCurrentSampleRate();
+    const int size = juce::jlimit (1, detail::engineMaxBlockSize, device->getCurrentBufferSizeSamples());
+    sampleRate = rate;
+    blockSize = size;
+
+    graph.setPlayConfigDetails (0, 2, rate, size);
+    graph.prepareToPlay (rate, size);
+
+    buffer.setSize (2, size);
+    midi.ensureSize ((size_t) events.size() * detail::engineBytesPerEvent);
+    chunkMidi.ensureSize ((size_t) events.size() * detail::engineBytesPerEvent);
+
+    // Nothing reads the queue until callbacks start, drop what went stale.
+    fifo.finishedRead (fifo.getNumReady());
+    running = true;
+}
+
+void Engine::audioDeviceStopped()
+{
+    running = false;
+    graph.releaseResources();
+}
+
+void Engine::collectMidi (int numSamples)
+{
+    midi.clear();
+
+    // The block covers the time since the last callback, played one block late.
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto rate = sampleRate.load (std::memory_order_relaxed);
+    const auto blockStart = now - (double) numSamples * 1000.0 / rate;
+    const auto samplesPerMs = rate * 0.001;
+
+    const int numReady = fifo.getNumReady();
+    const auto scope = fifo.read (numReady);
+    const auto place = [&] (int start, int count) {
+        for (int i = start; i < start + count; ++i) {
+            const auto& event = events[(size_t) i];
+            const int offset = juce::jlimit (0, numSamples - 1, (int) ((event.time - blockStart) * samplesPerMs));
+            midi.addEvent (event.data, event.size, offset);
+        }
+    };
+
+    place (scope.startIndex1, scope.blockSize1);
+    place (scope.startIndex2, scope.blockSize2);
+    numDelivered.fetch_add (numReady, std::memory_order_relaxed);
+}
+
+void Engine::sendChainOutput (const juce::MidiBuffer& output)
+{
+    auto* sender = chainOutput.load (std::memory_order_relaxed);
+    if (sender == nullptr)
+        return;
+
+    for (const auto metadata : output) {
+        const auto message = metadata.getMessage();
+        if (! message.isSysEx())
+            sender->add (message);
+    }
+}
+
+void Engine::audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                               int numInputChannels,
+                                               float* const* outputChannelData,
+                                               int numOutputChannels,
+                                               int numSamples,
+                                               const juce::AudioIODeviceCallbackContext& context)
+{
+    juce::ignoreUnused (inputChannelData, numInputChannels, context);
+    juce::ScopedNoDenormals noDenormals;
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+        if (outputChannelData[channel] != nullptr)
+            juce::FloatVectorOperations::clear (outputChannelData[channel], numSamples);
+
+    const bool monitor = monitoring.load (std::memory_order_relaxed);
+    const bool chain = pluginsActive.load (std::memory_order_relaxed);
+    if (! monitor && ! chain) {
+        // Keep the queue empty so turning monitoring on doesn't play old notes.
+        fifo.finishedRead (fifo.getNumReady());
+        return;
+    }
+
+    collectMidi (numSamples);
+
+    // Devices may call back with more than they said, process in prepared sized chunks.
+    const int chunkSize = blockSize.load (std::memory_order_relaxed);
+    for (int position = 0; position < numSamples; position += chunkSize) {
+        const int count = juce::jmin (chunkSize, numSamples - position);
+        chunkMidi.clear();
+        chunkMidi.addEvents (midi, position, count, -position);
+
+        juce::AudioBuffer<float> chunk (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), count);
+        graph.processBlock (chunk, chunkMidi);
+
+        // The graph leaves what came out of the chain in the MIDI buffer.
+        if (chain)
+            sendChainOutput (chunkMidi);
+        if (! monitor)
+            continue;
+
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+            if (outputChannelData[channel] != nullptr)
+                juce::FloatVectorOperations::copy (outputChannelData[channel] + position,
+                                                   chunk.getReadPointer (channel % chunk.getNumChannels()),
+                                                   count);
+    }
+}
+
+} // namespace vmc
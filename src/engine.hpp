@@ -6,13 +6,125 @@
 
 namespace vmc {
 
-class Engine final {
+class MidiSender;
+class SamplePlayer;
+
+/** The real-time core. Runs an AudioProcessorGraph from the audio device and
+    feeds it the MIDI the controller sends, so it can be heard locally.
+
+    Messages are stamped on the high resolution clock when queued. Each audio
+    callback places them one block late at their offset in time, so their
+    spacing survives callback jitter. Producers take a short spin lock to
+    reserve space, the audio thread reads without locking and nothing is
+    allocated there once the device has started. SysEx isn't passed on.
+
+    Plugins added with addPlugin() process the MIDI in series before the
+    instrument. While there are any, what comes out of the last one is queued
+    on the chain output to be sent, a block or two after it went in. The
+    chain output must poll, the audio thread only queues to it.
+*/
+class Engine final : public juce::AudioIODeviceCallback {
 public:
-    Engine() = default;
-    ~Engine() = default;
+    using NodeID = juce::AudioProcessorGraph::NodeID;
+
+    /** Which instrument the MIDI is played on. */
+    enum Instrument {
+        previewSynth = 0,
+        samplePlayer
+    };
+
+    explicit Engine (int capacity = 4096);
+    ~Engine() override;
+
+    /** Queues a message for the graph. Returns false if not monitoring, the
+        queue is full or the message is SysEx. Safe to call from any thread.
+    */
+    bool addMidiMessage (const juce::MidiMessage& message);
+
+    /** Turns the graph on or off. While off it isn't processed and the output is silent. */
+    void setMonitoring (bool shouldMonitor) noexcept { monitoring = shouldMonitor; }
+    bool isMonitoring() const noexcept { return monitoring.load(); }
+
+    /** Returns the graph, change it on the message thread only. */
+    juce::AudioProcessorGraph& getGraph() noexcept { return graph; }
+    /** Returns the node VMC's MIDI comes in from. */
+    NodeID getMidiInputNode() const noexcept { return midiInputNode; }
+    /** Returns the node that goes to the audio device. */
+    NodeID getAudioOutputNode() const noexcept { return audioOutputNode; }
+    /** Returns the built-in instrument used for auditioning. */
+    NodeID getInstrumentNode() const noexcept { return instrumentNode; }
+    /** Returns the node that plays the samples folder. */
+    NodeID getSamplerNode() const noexcept { return samplerNode; }
+
+    /** Routes the MIDI to one of the instruments. Call on the message thread. */
+    void setInstrument (Instrument newInstrument);
+    Instrument getInstrument() const noexcept { return instrument; }
+    /** Returns the sample player, load it with SamplePlayer::loadFolder(). */
+    SamplePlayer& getSamplePlayer() noexcept { return *samplePlayerProcessor; }
+
+    /** Appends a MIDI plugin to the chain. Call on the message thread. */
+    NodeID addPlugin (std::unique_ptr<juce::AudioPluginInstance> plugin);
+    /** Takes a plugin out of the chain. Call on the message thread. */
+    void removePlugin (int index);
+    int getNumPlugins() const noexcept { return (int) plugins.size(); }
+    juce::AudioPluginInstance* getPlugin (int index) const;
+    /** True while the chain has plugins, so MIDI should go out through it. */
+    bool hasPlugins() const noexcept { return pluginsActive.load(); }
+
+    /** Sets where the chain's output is queued, it must outlive the engine's use. */
+    void setChainOutput (MidiSender* sender) noexcept { chainOutput = sender; }
+
+    /** Returns the sample rate the graph runs at. */
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+    /** Returns the block size the graph is prepared for. */
+    int getBlockSize() const noexcept { return juce::jmax (512, blockSize.load()); }
+
+    /** Returns the number of messages dropped because the queue was full. */
+    juce::int64 getNumDropped() const noexcept { return numDropped.load(); }
+    /** Returns the number of messages passed to the graph. */
+    juce::int64 getNumDelivered() const noexcept { return numDelivered.load(); }
+
+    //=========================================================================
+    void audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                           int numInputChannels,
+                                           float* const* outputChannelData,
+                                           int numOutputChannels,
+                                           int numSamples,
+                                           const juce::AudioIODeviceCallbackContext& context) override;
+    void audioDeviceAboutToStart (juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
 
 private:
-    juce::AudioProcessorPlayer _player;
+    struct Event {
+        juce::uint8 data[3] {};
+        juce::uint8 size = 0;
+        double time = 0.0;
+    };
+
+    juce::AudioProcessorGraph graph;
+    NodeID midiInputNode, midiOutputNode, audioOutputNode, instrumentNode, samplerNode;
+    std::vector<NodeID> plugins;
+    SamplePlayer* samplePlayerProcessor = nullptr;
+    Instrument instrument = previewSynth;
+
+    juce::AbstractFifo fifo;
+    std::vector<Event> events;
+    juce::SpinLock writeLock;
+    std::atomic<bool> monitoring { false }, running { false }, pluginsActive { false };
+    std::atomic<MidiSender*> chainOutput { nullptr };
+    std::atomic<juce::int64> numDropped { 0 }, numDelivered { 0 };
+
+    // Used only by the audio thread, sized when the device starts.
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi, chunkMidi;
+    // Written when the device starts, which can be on the device thread.
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<int> blockSize { 0 };
+
+    void collectMidi (int numSamples);
+    void sendChainOutput (const juce::MidiBuffer& output);
+    void updateMidiConnections();
+
     Engine (const Engine&) = delete;
     Engine& operator= (const Engine&) = delete;
     Engine (Engine&&) = delete;
@@ -0,0 +1,512 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "headless.hpp"
+#include "controller.hpp"
+#include "device.hpp"
+#include "latencytracer.hpp"
+#include "midisender.hpp"
+#include "oscserver.hpp"
+#include "sharedmidiring.hpp"
+#include "stallwatchdog.hpp"
+#include "stressgenerator.hpp"
+
+#if ! JUCE_WINDOWS
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+#include <iostream>
+
+namespace vmc {
+namespace detail {
+static const char* headlessHelp =
+    "commands:\n"
+    "  note <key> [velocity]    send a note on (velocity 1-127)\n"
+    "  off <key>                send a note off\n"
+    "  panic                    release all held notes\n"
+    "  cc <number> <value>      send a control change\n"
+    "  dial <index> <value>     set a dial (1-based)\n"
+    "  fader <index> <value>    set a fader (1-based)\n"
+    "  program <1-128>          set the device program\n"
+    "  channel <1-16>           set the device MIDI channel\n"
+    "  load <file>              load a device file\n"
+    "  save [file]              save the device\n"
+    "  dump                     send the device as a SysEx dump\n"
+    "  outputs                  list MIDI outputs\n"
+    "  output <index|name|none> choose the MIDI output\n"
+    "  status                   show the current state\n"
+    "  osc                      show OSC server stats\n"
+    "  latency [on|off|reset]   show or control the latency tracer\n"
+    "  stress <cc|notes|mixed> <rate> [n] [seconds]\n"
+    "                           send synthetic MIDI at a rate of 1-10000/s, n is\n"
+    "                           controllers or polyphony\n"
+    "  stress [stop]            show stress stats or stop\n"
+    "  watchdog [on|off|<ms>]   show or control the stall watchdog, a number\n"
+    "                           sets the threshold and starts it\n"
+    "  quit                     exit";
+
+static juce::String ok (const juce::String& text = {})
+{
+    return text.isEmpty() ? juce::String ("ok") : "ok " + text;
+}
+
+static juce::String error (const juce::String& text)
+{
+    return "error: " + text;
+}
+
+/** Runs a command on the message thread and waits for the response. */
+static juce::String executeOnMessageThread (juce::WeakReference<CommandProcessor> commands,
+                                            const juce::String& line,
+                                            juce::Thread& caller)
+{
+    struct PendingCall {
+        juce::WaitableEvent done;
+        juce::String result;
+    };
+
+    auto call = std::make_shared<PendingCall>();
+    juce::MessageManager::callAsync ([commands, line, call]() {
+        if (auto* cp = commands.get())
+            call->result = cp->execute (line);
+        call->done.signal();
+    });
+
+    while (! call->done.wait (100))
+        if (caller.threadShouldExit())
+            return {};
+
+    return call->result;
+}
+} // namespace detail
+
+//==============================================================================
+CommandProcessor::CommandProcessor (Controller& c)
+    : controller (c)
+{
+}
+
+juce::String CommandProcessor::executeAll (const juce::String& commandList)
+{
+    juce::StringArray results;
+    for (const auto& line : juce::StringArray::fromTokens (commandList, ";", "\""))
+        if (line.trim().isNotEmpty())
+            results.add (execute (line));
+    return results.joinIntoString ("\n");
+}
+
+juce::String CommandProcessor::execute (const juce::String& line)
+{
+    const ScopedLatencyTrace trace (controller.getLatencyTracer());
+    auto args = juce::StringArray::fromTokens (line.trim(), true);
+    args.removeEmptyStrings();
+    if (args.isEmpty())
+        return {};
+
+    const auto command = args[0].toLowerCase();
+    args.remove (0);
+
+    auto device = controller.device();
+    auto& keyboard = controller.getMidiKeyboardState();
+    const int channel = juce::jlimit (1, 16, device.midiChannel());
+
+    if (command == "help")
+        return detail::headlessHelp;
+
+    if (command == "note" || command == "on") {
+        if (args.isEmpty())
+            return detail::error ("usage: note <key> [velocity]");
+        const int key = juce::jlimit (0, 127, args[0].getIntValue());
+        const int velocity = args.size() > 1 ? juce::jlimit (1, 127, args[1].getIntValue()) : 100;
+        keyboard.noteOn (channel, key, (float) velocity / 127.0f);
+        return detail::ok();
+    }
+
+    if (command == "off") {
+        if (args.isEmpty())
+            return detail::error ("usage: off <key>");
+        keyboard.noteOff (channel, juce::jlimit (0, 127, args[0].getIntValue()), 0.0f);
+        return detail::ok();
+    }
+
+    if (command == "panic") {
+        keyboard.allNotesOff (0);
+        return detail::ok();
+    }
+
+    if (command == "cc") {
+        if (args.size() < 2)
+            return detail::error ("usage: cc <number> <value>");
+        controller.addMidiMessage (juce::MidiMessage::controllerEvent (channel,
+                                                                       juce::jlimit (0, 127, args[0].getIntValue()),
+                                                                       juce::jlimit (0, 127, args[1].getIntValue())));
+        return detail::ok();
+    }
+
+    if (command == "dial")
+        return setRanged (device.dials(), args);
+    if (command == "fader")
+        return setRanged (device.faders(), args);
+
+    if (command == "program") {
+        if (args.isEmpty())
+            return detail::error ("usage: program <1-128>");
+        device.setMidiProgram (args[0].getIntValue());
+        return detail::ok (juce::String (device.midiProgram()));
+    }
+
+    if (command == "channel") {
+        if (args.isEmpty())
+            return detail::error ("usage: channel <1-16>");
+        device.setMidiChannel (args[0].getIntValue());
+        return detail::ok (juce::String (device.midiChannel()));
+    }
+
+    if (command == "load") {
+        const auto path = args.joinIntoString (" ").unquoted();
+        if (! juce::File::isAbsolutePath (path))
+            return detail::error ("an absolute path is required");
+        return controller.loadDeviceFile (juce::File (path)) ? detail::ok() : detail::error ("could not load " + path);
+    }
+
+    if (command == "save") {
+        auto file = controller.deviceFile();
+        if (! args.isEmpty()) {
+            const auto path = args.joinIntoString (" ").unquoted();
+            if (! juce::File::isAbsolutePath (path))
+                return detail::error ("an absolute path is required");
+            file = juce::File (path);
+        }
+        if (file == juce::File())
+            return detail::error ("no device file");
+        device.save (file);
+        return detail::ok (file.getFullPathName());
+    }
+
+    if (command == "dump")
+        return controller.sendDeviceDump() ? detail::ok() : detail::error ("a dump is already being sent");
+
+    if (command == "outputs")
+        return listOutputs();
+    if (command == "output")
+        return selectOutput (args.joinIntoString (" ").unquoted());
+
+    if (command == "status")
+        return status();
+
+    if (command == "osc") {
+        if (auto* osc = controller.getOscServer())
+            return detail::ok (osc->getStatsText());
+        return detail::error ("the OSC server is not running, start with --osc-port");
+    }
+
+    if (command == "latency") {
+        auto& tracer = controller.getLatencyTracer();
+        const auto option = args[0].toLowerCase();
+        if (option == "on" || option == "off")
+            tracer.setEnabled (option == "on");
+        else if (option == "reset")
+            tracer.reset();
+        else if (option.isNotEmpty())
+            return detail::error ("usage: latency [on|off|reset]");
+        return detail::ok (juce::String (tracer.isEnabled() ? "tracing" : "not tracing") + "\n"
+                           + tracer.getSummary().joinIntoString ("\n"));
+    }
+
+    if (command == "stress")
+        return stress (args);
+
+    if (command == "watchdog") {
+        auto& watchdog = controller.getStallWatchdog();
+        const auto option = args[0].toLowerCase();
+        int threshold = 0;
+        if (option == "off")
+            watchdog.stop();
+        else if (option == "on" && ! watchdog.isRunning())
+            threshold = watchdog.getThreshold();
+        else if (option.containsOnly ("0123456789") && option.getIntValue() > 0)
+            threshold = option.getIntValue();
+        else if (option.isNotEmpty() && option != "on")
+            return detail::error ("usage: watchdog [on|off|<ms>]");
+
+        if (threshold > 0 && ! watchdog.start (threshold, StallWatchdog::getDefaultLogFile()))
+            return detail::error ("could not write " + StallWatchdog::getDefaultLogFile().getFullPathName());
+
+        auto text = watchdog.getSummary() + "\nlog " + watchdog.getLogFile().getFullPathName();
+        if (watchdog.getNumStalls() > 0)
+            text << "\nlast " << watchdog.getLastStall().toString();
+        return detail::ok (text);
+    }
+
+    if (command == "quit" || command == "exit") {
+        if (onQuit)
+            onQuit();
+        return detail::ok();
+    }
+
+    return detail::error ("unknown command '" + command + "', try 'help'");
+}
+
+juce::String CommandProcessor::setRanged (const juce::ValueTree& parent, const juce::StringArray& args)
+{
+    if (args.size() < 2)
+        return detail::error ("usage: <index> <value>");
+
+    auto child = parent.getChild (args[0].getIntValue() - 1);
+    if (! child.isValid())
+        return detail::error ("no control " + args[0]);
+
+    LatencyTracer::mark (LatencyTracer::valueChange);
+    child.setProperty (Device::valueID, juce::jlimit (0, 127, args[1].getIntValue()), nullptr);
+    return detail::ok();
+}
+
+juce::String CommandProcessor::stress (const juce::StringArray& args)
+{
+    auto& generator = controller.getStressGenerator();
+    if (args.isEmpty())
+        return detail::ok (generator.getStats().toString());
+
+    if (args[0].equalsIgnoreCase ("stop")) {
+        generator.stop();
+        return detail::ok (generator.getStats().toString());
+    }
+
+    StressGenerator::Options options;
+    if (! StressGenerator::parseMode (args[0], options.mode) || args.size() < 2)
+        return detail::error ("usage: stress <cc|notes|mixed> <rate> [n] [seconds]");
+
+    options.rate = args[1].getDoubleValue();
+    if (args.size() > 2) {
+        options.numControllers = args[2].getIntValue();
+        options.polyphony = args[2].getIntValue();
+    }
+    if (args.size() > 3)
+        options.duration = args[3].getDoubleValue();
+    options.channel = juce::jlimit (1, 16, controller.device().midiChannel());
+
+    return generator.start (options) ? detail::ok() : detail::error ("could not start the generator");
+}
+
+juce::String CommandProcessor::listOutputs() const
+{
+    const auto current = controller.getDeviceManager().getDefaultMidiOutputIdentifier();
+    const auto outputs = controller.getMidiOutputs();
+
+    juce::StringArray lines;
+    lines.add (juce::String (current.isEmpty() ? "* " : "  ") + "0: None");
+    for (int i = 0; i < outputs.size(); ++i) {
+        const auto& info = outputs.getReference (i);
+        lines.add (juce::String (info.identifier == current ? "* " : "  ")
+                   + juce::String (i + 1) + ": " + info.name);
+    }
+    return lines.joinIntoString ("\n");
+}
+
+juce::String CommandProcessor::selectOutput (const juce::String& nameOrIndex)
+{
+    if (nameOrIndex.isEmpty() || nameOrIndex == "0" || nameOrIndex.equalsIgnoreCase ("none")) {
+        controller.setDefaultMidiOutput ({});
+        return detail::ok();
+    }
+
+    const auto outputs = controller.getMidiOutputs();
+    const int index = nameOrIndex.containsOnly ("0123456789") ? nameOrIndex.getIntValue() - 1 : -1;
+
+    for (int i = 0; i < outputs.size(); ++i) {
+        const auto& info = outputs.getReference (i);
+        if (i == index || info.name.equalsIgnoreCase (nameOrIndex) || info.identifier == nameOrIndex) {
+            controller.setDefaultMidiOutput (info.identifier);
+            return detail::ok (info.name);
+        }
+    }
+
+    return detail::error ("no output '" + nameOrIndex + "'");
+}
+
+juce::String CommandProcessor::status() const
+{
+    auto device = controller.device();
+    juce::String text;
+    text << "device: " << device.name() << "\n"
+         << "file: " << controller.deviceFile().getFullPathName() << "\n"
+         << "channel: " << device.midiChannel() << "\n"
+         << "program: " << device.midiProgram() << "\n"
+         << "output: " << controller.getDeviceManager().getDefaultMidiOutputIdentifier();
+
+    const auto& sender = controller.getMidiSender();
+    text << "\nsent: " << sender.getNumSent() << ", dropped: " << sender.getNumDropped()
+         << ", queue latency avg " << juce::String (sender.getAverageLatency(), 3) << " ms";
+
+    if (auto* ring = controller.getSharedMidiRing())
+        text << "\nring " << ring->getName() << ": " << sender.getNumInjected() << " injected, max lateness "
+             << juce::String (sender.getMaxLateness(), 3) << " ms";
+    return text;
+}
+
+//==============================================================================
+class HeadlessServer::StdinReader final : public juce::Thread {
+public:
+    explicit StdinReader (juce::WeakReference<CommandProcessor> cp)
+        : juce::Thread ("VMC Stdin"), commands (cp) {}
+
+    ~StdinReader() override { stopThread (1000); }
+
+    void run() override
+    {
+#if JUCE_WINDOWS
+        std::string line;
+        while (! threadShouldExit() && std::getline (std::cin, line))
+            respond (juce::String (line));
+#else
+        juce::String pending;
+        char buffer[512];
+
+        while (! threadShouldExit()) {
+            pollfd fds { STDIN_FILENO, POLLIN, 0 };
+            const int ready = ::poll (&fds, 1, 200);
+            if (ready <= 0)
+                continue;
+
+            const auto numRead = ::read (STDIN_FILENO, buffer, sizeof (buffer));
+            if (numRead <= 0)
+                break; // EOF, keep running on the other inputs
+
+            pending += juce::String::fromUTF8 (buffer, (int) numRead);
+            for (int newline = pending.indexOfChar ('\n'); newline >= 0; newline = pending.indexOfChar ('\n')) {
+                respond (pending.substring (0, newline));
+                pending = pending.substring (newline + 1);
+            }
+        }
+#endif
+    }
+
+private:
+    juce::WeakReference<CommandProcessor> commands;
+
+    void respond (const juce::String& line)
+    {
+        if (line.trim().isEmpty())
+            return;
+        const auto result = detail::executeOnMessageThread (commands, line, *this);
+        std::cout << result << std::endl;
+    }
+};
+
+//==============================================================================
+class HeadlessServer::SocketListener final : public juce::Thread {
+public:
+    SocketListener (juce::WeakReference<CommandProcessor> cp, int p)
+        : juce::Thread ("VMC Control Socket"), commands (cp), port (p) {}
+
+    ~SocketListener() override
+    {
+        signalThreadShouldExit();
+        server.close();
+        stopThread (2000);
+        clients.clear();
+    }
+
+    bool start()
+    {
+        if (! server.createListener (port, "127.0.0.1"))
+            return false;
+        return startThread();
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit()) {
+            for (int i = clients.size(); --i >= 0;)
+                if (! clients.getUnchecked (i)->isThreadRunning())
+                    clients.remove (i);
+
+            if (server.waitUntilReady (true, 200) <= 0)
+                continue;
+
+            if (auto* socket = server.waitForNextConnection()) {
+                auto* client = clients.add (new Client (commands, socket));
+                client->startThread();
+            }
+        }
+    }
+
+private:
+    class Client final : public juce::Thread {
+    public:
+        Client (juce::WeakReference<CommandProcessor> cp, juce::StreamingSocket* s)
+            : juce::Thread ("VMC Control Client"), commands (cp), socket (s) {}
+
+        ~Client() override
+        {
+            signalThreadShouldExit();
+            socket->close();
+            stopThread (1000);
+        }
+
+        void run() override
+        {
+            juce::String pending;
+            char buffer[512];
+
+            while (! threadShouldExit() && socket->isConnected()) {
+                const int ready = socket->waitUntilReady (true, 200);
+                if (ready == 0)
+                    continue;
+
+                const int numRead = ready > 0 ? socket->read (buffer, (int) sizeof (buffer), false) : -1;
+                if (numRead <= 0)
+                    break;
+
+                pending += juce::String::fromUTF8 (buffer, numRead);
+                for (int newline = pending.indexOfChar ('\n'); newline >= 0; newline = pending.indexOfChar ('\n')) {
+                    const auto line = pending.substring (0, newline).trim();
+                    pending = pending.substring (newline + 1);
+                    if (line.isEmpty())
+                        continue;
+
+                    const auto result = detail::executeOnMessageThread (commands, line, *this) + "\n";
+                    socket->write (result.toRawUTF8(), (int) result.getNumBytesAsUTF8());
+                }
+            }
+        }
+
+    private:
+        juce::WeakReference<CommandProcessor> commands;
+        std::unique_ptr<juce::StreamingSocket> socket;
+    };
+
+    juce::WeakReference<CommandProcessor> commands;
+    const int port;
+    juce::StreamingSocket server;
+    juce::OwnedArray<Client> clients;
+};
+
+//==============================================================================
+HeadlessServer::HeadlessServer (Controller& controller, const Options& options)
+    : commands (controller)
+{
+    juce::WeakReference<CommandProcessor> ref (&commands);
+
+    if (options.readStdin) {
+        stdinReader = std::make_unique<StdinReader> (ref);
+        stdinReader->startThread();
+    }
+
+    if (options.port > 0) {
+        socketListener = std::make_unique<SocketListener> (ref, options.port);
+        if (! socketListener->start()) {
+            std::cerr << "vmc: could not listen on port " << options.port << std::endl;
+            socketListener.reset();
+        }
+    }
+}
+
+HeadlessServer::~HeadlessServer()
+{
+    socketListener.reset();
+    stdinReader.reset();
+}
+
+} // namespace vmc
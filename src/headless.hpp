@@ -0,0 +1,72 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+class Controller;
+
+/** Executes text commands against a Controller.
+
+    Used by headless mode for stdin, the local control socket and commands
+    passed on the command line. Must be called on the message thread.
+*/
+class CommandProcessor final {
+public:
+    explicit CommandProcessor (Controller& controller);
+
+    /** Runs a single command line and returns the response text. */
+    juce::String execute (const juce::String& line);
+
+    /** Runs several commands separated by semicolons. */
+    juce::String executeAll (const juce::String& commands);
+
+    /** Called when the quit command is received. */
+    std::function<void()> onQuit;
+
+private:
+    Controller& controller;
+
+    juce::String setRanged (const juce::ValueTree& parent, const juce::StringArray& args);
+    juce::String stress (const juce::StringArray& args);
+    juce::String selectOutput (const juce::String& nameOrIndex);
+    juce::String listOutputs() const;
+    juce::String status() const;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (CommandProcessor)
+    JUCE_DECLARE_NON_COPYABLE (CommandProcessor)
+};
+
+/** Runs a Controller without any GUI, taking commands from stdin and a
+    local TCP socket.
+*/
+class HeadlessServer final {
+public:
+    struct Options {
+        bool readStdin = true;
+        int port = 0; // 0 disables the socket
+    };
+
+    HeadlessServer (Controller& controller, const Options& options);
+    ~HeadlessServer();
+
+    /** Returns the command processor. */
+    CommandProcessor& getCommands() noexcept { return commands; }
+
+    /** Returns the default port for the control socket. */
+    static constexpr int defaultPort = 7427;
+
+private:
+    class StdinReader;
+    class SocketListener;
+    CommandProcessor commands;
+    std::unique_ptr<StdinReader> stdinReader;
+    std::unique_ptr<SocketListener> socketListener;
+
+    JUCE_DECLARE_NON_COPYABLE (HeadlessServer)
+};
+
+} // namespace vmc
@@ -0,0 +1,209 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "latencytracer.hpp"
+
+namespace vmc {
+namespace detail {
+static thread_local LatencyTracer::Trace* currentTrace = nullptr;
+
+static int highestBit (juce::uint64 value) noexcept
+{
+    int bit = -1;
+    while (value != 0) {
+        value >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+} // namespace detail
+
+//==============================================================================
+int LatencyHistogram::getBucketIndex (juce::int64 micros) noexcept
+{
+    const auto value = (juce::uint64) juce::jlimit ((juce::int64) 0, ((juce::int64) 1 << (maxMagnitude + 1)) - 1, micros);
+    if (value < (juce::uint64) (2 * subBuckets))
+        return (int) value;
+
+    const int magnitude = detail::highestBit (value);
+    const int shift = magnitude - subBucketBits;
+    const int top = (int) (value >> shift);
+    return 2 * subBuckets + (magnitude - subBucketBits - 1) * subBuckets + (top - subBuckets);
+}
+
+juce::int64 LatencyHistogram::getBucketStart (int index) noexcept
+{
+    if (index < 2 * subBuckets)
+        return index;
+
+    const int offset = index - 2 * subBuckets;
+    const int magnitude = offset / subBuckets + subBucketBits + 1;
+    const int top = offset % subBuckets + subBuckets;
+    return (juce::int64) top << (magnitude - subBucketBits);
+}
+
+void LatencyHistogram::record (juce::int64 micros) noexcept
+{
+    micros = juce::jmax ((juce::int64) 0, micros);
+    buckets[(size_t) getBucketIndex (micros)].fetch_add (1, std::memory_order_relaxed);
+    total.fetch_add (micros, std::memory_order_relaxed);
+    count.fetch_add (1, std::memory_order_relaxed);
+
+    auto previous = maxValue.load (std::memory_order_relaxed);
+    while (micros > previous && ! maxValue.compare_exchange_weak (previous, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store (0, std::memory_order_relaxed);
+    count = 0;
+    total = 0;
+    maxValue = 0;
+}
+
+double LatencyHistogram::getMean() const noexcept
+{
+    const auto n = count.load();
+    return n > 0 ? (double) total.load() / (double) n : 0.0;
+}
+
+juce::int64 LatencyHistogram::getPercentile (double percentile) const noexcept
+{
+    juce::int64 n = 0;
+    for (const auto& bucket : buckets)
+        n += bucket.load (std::memory_order_relaxed);
+    if (n == 0)
+        return 0;
+
+    const auto target = juce::jmax ((juce::int64) 1, (juce::int64) std::ceil (percentile * 0.01 * (double) n));
+    juce::int64 seen = 0;
+    for (int i = 0; i < numBuckets; ++i) {
+        seen += buckets[(size_t) i].load (std::memory_order_relaxed);
+        if (seen >= target)
+            return juce::jmin (getBucketStart (i + 1) - 1, getMax());
+    }
+    return getMax();
+}
+
+//==============================================================================
+const char* LatencyTracer::getStageName (int stage) noexcept
+{
+    switch (stage) {
+        case input:
+            return "total";
+        case valueChange:
+            return "value";
+        case dispatch:
+            return "dispatch";
+        case enqueue:
+            return "enqueue";
+        case send:
+            return "send";
+        default:
+            break;
+    }
+    return "";
+}
+
+void LatencyTracer::mark (Stage stage) noexcept
+{
+    if (auto* trace = detail::currentTrace)
+        trace->times[(size_t) stage] = juce::Time::getMillisecondCounterHiRes();
+}
+
+const LatencyTracer::Trace* LatencyTracer::getCurrentTrace() noexcept
+{
+    return detail::currentTrace;
+}
+
+void LatencyTracer::record (const Trace& trace) noexcept
+{
+    const auto& times = trace.times;
+    if (times[input] <= 0.0 || times[send] <= 0.0)
+        return;
+
+    // Each stage reached is measured from the last stage reached before it.
+    double previous = times[input];
+    for (int stage = valueChange; stage < numStages; ++stage) {
+        const auto time = times[(size_t) stage];
+        if (time <= 0.0)
+            continue;
+        histograms[(size_t) stage].record ((juce::int64) ((time - previous) * 1000.0));
+        previous = time;
+    }
+
+    histograms[input].record ((juce::int64) ((times[send] - times[input]) * 1000.0));
+}
+
+void LatencyTracer::reset() noexcept
+{
+    for (auto& histogram : histograms)
+        histogram.reset();
+}
+
+juce::StringArray LatencyTracer::getSummary() const
+{
+    juce::StringArray lines;
+    lines.add ("stage       count     p50 us     p99 us   p99.9 us     max us");
+    for (const auto stage : { valueChange, dispatch, enqueue, send, input }) {
+        const auto& histogram = histograms[(size_t) stage];
+        lines.add (juce::String (getStageName (stage)).paddedRight (' ', 8)
+                   + juce::String (histogram.getCount()).paddedLeft (' ', 9)
+                   + juce::String (histogram.getPercentile (50.0)).paddedLeft (' ', 11)
+                   + juce::String (histogram.getPercentile (99.0)).paddedLeft (' ', 11)
+                   + juce::String (histogram.getPercentile (99.9)).paddedLeft (' ', 11)
+                   + juce::String (histogram.getMax()).paddedLeft (' ', 11));
+    }
+    return lines;
+}
+
+juce::String LatencyTracer::toCsv() const
+{
+    juce::String csv ("stage,count,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us\n");
+    for (const auto stage : { valueChange, dispatch, enqueue, send, input }) {
+        const auto& histogram = histograms[(size_t) stage];
+        csv << getStageName (stage) << ","
+            << histogram.getCount() << ","
+            << juce::String (histogram.getMean(), 2) << ","
+            << histogram.getPercentile (50.0) << ","
+            << histogram.getPercentile (90.0) << ","
+            << histogram.getPercentile (99.0) << ","
+            << histogram.getPercentile (99.9) << ","
+            << histogram.getMax() << "\n";
+    }
+
+    csv << "\nstage,from_us,to_us,count\n";
+    for (const auto stage : { valueChange, dispatch, enqueue, send, input }) {
+        histograms[(size_t) stage].forEachBucket ([&csv, stage] (juce::int64 from, juce::int64 to, juce::uint32 n) {
+            csv << getStageName (stage) << "," << from << "," << to << "," << (int) n << "\n";
+        });
+    }
+    return csv;
+}
+
+//==============================================================================
+ScopedLatencyTrace::ScopedLatencyTrace (LatencyTracer& tracer, double inputTime) noexcept
+{
+    if (! tracer.isEnabled() || detail::currentTrace != nullptr)
+        return;
+
+    trace.tracer = &tracer;
+    trace.times[LatencyTracer::input] = inputTime;
+    detail::currentTrace = &trace;
+    active = true;
+}
+
+ScopedLatencyTrace::ScopedLatencyTrace (LatencyTracer& tracer) noexcept
+    : ScopedLatencyTrace (tracer, juce::Time::getMillisecondCounterHiRes())
+{
+}
+
+ScopedLatencyTrace::~ScopedLatencyTrace()
+{
+    if (active)
+        detail::currentTrace = nullptr;
+}
+
+} // namespace vmc
@@ -0,0 +1,129 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+/** A histogram of microsecond values with buckets that get wider as values
+    grow, so it keeps about 3% precision from 1 us to hours in a fixed
+    amount of memory. Recording is lock and allocation free from any thread.
+*/
+class LatencyHistogram final {
+public:
+    LatencyHistogram() = default;
+
+    /** Adds a value in microseconds. */
+    void record (juce::int64 micros) noexcept;
+    /** Clears all counts. Values recorded at the same time may be lost. */
+    void reset() noexcept;
+
+    juce::int64 getCount() const noexcept { return count.load(); }
+    juce::int64 getMax() const noexcept { return maxValue.load(); }
+    double getMean() const noexcept;
+    /** Returns a percentile (0-100) in microseconds, to the bucket's precision. */
+    juce::int64 getPercentile (double percentile) const noexcept;
+
+    /** Calls a function with the range and count of every bucket that has values. */
+    template <typename Function>
+    void forEachBucket (Function&& function) const
+    {
+        for (int i = 0; i < numBuckets; ++i)
+            if (const auto n = buckets[(size_t) i].load (std::memory_order_relaxed))
+                function (getBucketStart (i), getBucketStart (i + 1) - 1, n);
+    }
+
+private:
+    static constexpr int subBucketBits = 5;
+    static constexpr int subBuckets = 1 << subBucketBits;
+    static constexpr int maxMagnitude = 36;
+    static constexpr int numBuckets = 2 * subBuckets + (maxMagnitude - subBucketBits) * subBuckets;
+
+    std::array<std::atomic<juce::uint32>, (size_t) numBuckets> buckets {};
+    std::atomic<juce::int64> count { 0 }, total { 0 }, maxValue { 0 };
+
+    static int getBucketIndex (juce::int64 micros) noexcept;
+    static juce::int64 getBucketStart (int index) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (LatencyHistogram)
+};
+
+/** Follows outgoing events from the gesture that made them to the sink.
+
+    Input handlers start a ScopedLatencyTrace. Each later stage on the same
+    thread marks the time it was reached, the MIDI sender copies the trace
+    with the message and records it here after the send. The time each stage
+    took after the one before it is kept in a histogram, along with the
+    total from input to send. Costs nothing but a thread local check while
+    disabled.
+*/
+class LatencyTracer final {
+public:
+    enum Stage {
+        input = 0,
+        valueChange,
+        dispatch,
+        enqueue,
+        send,
+        numStages
+    };
+
+    /** Stage times in milliseconds from Time::getMillisecondCounterHiRes(), zero if not reached. */
+    struct Trace {
+        std::array<double, numStages> times {};
+        LatencyTracer* tracer = nullptr;
+    };
+
+    LatencyTracer() = default;
+
+    /** Returns the name of a stage. */
+    static const char* getStageName (int stage) noexcept;
+
+    void setEnabled (bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+    bool isEnabled() const noexcept { return enabled.load (std::memory_order_relaxed); }
+
+    /** Marks a stage of the trace active on this thread, if there is one. */
+    static void mark (Stage stage) noexcept;
+    /** Returns the trace active on this thread, or null. */
+    static const Trace* getCurrentTrace() noexcept;
+
+    /** Adds a finished trace to the histograms. Lock free, call from any thread. */
+    void record (const Trace& trace) noexcept;
+    /** Clears the histograms. */
+    void reset() noexcept;
+
+    /** Returns the histogram for the time from the previous stage to this
+        one, or the total from input to send for Stage::input.
+    */
+    const LatencyHistogram& getHistogram (Stage stage) const noexcept { return histograms[(size_t) stage]; }
+
+    /** Returns one line per stage: count, percentiles and max in microseconds. */
+    juce::StringArray getSummary() const;
+    /** Returns the summary then every non-empty bucket as CSV. */
+    juce::String toCsv() const;
+
+private:
+    std::atomic<bool> enabled { false };
+    std::array<LatencyHistogram, numStages> histograms;
+
+    JUCE_DECLARE_NON_COPYABLE (LatencyTracer)
+};
+
+/** Starts a trace on this thread if the tracer is enabled and none is active. */
+class ScopedLatencyTrace final {
+public:
+    /** Starts a trace from an input time in Time::getMillisecondCounterHiRes() milliseconds. */
+    ScopedLatencyTrace (LatencyTracer& tracer, double inputTime) noexcept;
+    /** Starts a trace from now. */
+    explicit ScopedLatencyTrace (LatencyTracer& tracer) noexcept;
+    ~ScopedLatencyTrace();
+
+private:
+    LatencyTracer::Trace trace;
+    bool active = false;
+    JUCE_DECLARE_NON_COPYABLE (ScopedLatencyTrace)
+};
+
+} // namespace vmc
@@ -0,0 +1,108 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "latencytracercomponent.hpp"
+#include "controller.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int tracerLineHeight = 16;
+
+inline static void styleTracerButton (juce::Button& button, const juce::String& text)
+{
+    button.setButtonText (text);
+    button.setColour (juce::TextButton::textColourOffId, juce::Colours::white.withAlpha (0.8f));
+    button.setColour (juce::TextButton::textColourOnId, juce::Colours::white);
+    button.setColour (juce::ToggleButton::textColourId, juce::Colours::white.withAlpha (0.8f));
+}
+} // namespace detail
+
+LatencyTracerComponent::LatencyTracerComponent (Controller& c)
+    : controller (c)
+{
+    auto& tracer = controller.getLatencyTracer();
+
+    addAndMakeVisible (enableButton);
+    detail::styleTracerButton (enableButton, "Trace");
+    enableButton.setTooltip ("Time events at each stage from input to send");
+    enableButton.setToggleState (tracer.isEnabled(), juce::dontSendNotification);
+    enableButton.onClick = [this]() {
+        controller.getLatencyTracer().setEnabled (enableButton.getToggleState());
+    };
+
+    addAndMakeVisible (resetButton);
+    detail::styleTracerButton (resetButton, "Reset");
+    resetButton.onClick = [this]() {
+        controller.getLatencyTracer().reset();
+        timerCallback();
+    };
+
+    addAndMakeVisible (exportButton);
+    detail::styleTracerButton (exportButton, "Export...");
+    exportButton.onClick = [this]() { exportCsv(); };
+
+    timerCallback();
+    startTimerHz (4);
+    setSize (480, 40 + 8 * detail::tracerLineHeight);
+}
+
+LatencyTracerComponent::~LatencyTracerComponent()
+{
+    stopTimer();
+}
+
+void LatencyTracerComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour::fromRGB (45, 48, 52));
+
+    g.setColour (juce::Colours::white.withAlpha (0.9f));
+    g.setFont (juce::Font (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain)));
+
+    auto r = getLocalBounds().reduced (8).withTrimmedTop (32);
+    for (const auto& line : lines)
+        g.drawText (line, r.removeFromTop (detail::tracerLineHeight), juce::Justification::centredLeft, false);
+}
+
+void LatencyTracerComponent::resized()
+{
+    auto r = getLocalBounds().reduced (8);
+    auto row = r.removeFromTop (24);
+    enableButton.setBounds (row.removeFromLeft (80));
+    exportButton.setBounds (row.removeFromRight (80));
+    row.removeFromRight (6);
+    resetButton.setBounds (row.removeFromRight (80));
+}
+
+void LatencyTracerComponent::exportCsv()
+{
+    chooser = std::make_unique<juce::FileChooser> (
+        "Export Latency Trace",
+        Controller::getUserDataPath().getChildFile ("latency.csv"),
+        "*.csv",
+        true);
+
+    const auto csv = controller.getLatencyTracer().toCsv();
+    chooser->launchAsync (
+        juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+        [csv] (const juce::FileChooser& fc) {
+            auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
+            file.withFileExtension (".csv").replaceWithText (csv);
+        });
+}
+
+void LatencyTracerComponent::timerCallback()
+{
+    auto& tracer = controller.getLatencyTracer();
+    lines = tracer.getSummary();
+    lines.add ({});
+    lines.add (tracer.isEnabled() ? "Each stage is timed from the one before it, total is input to send."
+                                  : "Tracing is off.");
+    enableButton.setToggleState (tracer.isEnabled(), juce::dontSendNotification);
+    repaint();
+}
+
+} // namespace vmc
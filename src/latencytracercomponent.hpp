@@ -0,0 +1,39 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace vmc {
+
+class Controller;
+
+/** Shows the latency tracer's histograms per stage, with controls to turn
+    tracing on, clear it and export it as CSV.
+*/
+class LatencyTracerComponent : public juce::Component,
+                               private juce::Timer {
+public:
+    LatencyTracerComponent (Controller& controller);
+    ~LatencyTracerComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    Controller& controller;
+    juce::ToggleButton enableButton;
+    juce::TextButton resetButton;
+    juce::TextButton exportButton;
+    juce::StringArray lines;
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    void exportCsv();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LatencyTracerComponent)
+};
+
+} // namespace vmc
@@ -0,0 +1,239 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "librarian.hpp"
+#include "controller.hpp"
+
+namespace vmc {
+namespace detail {
+/** Reads SysEx messages one at a time from a memory mapped .syx file. */
+class MappedSysExSource final : public SysExSender::Source {
+public:
+    explicit MappedSysExSource (const juce::File& file)
+        : map (file, juce::MemoryMappedFile::readOnly, false) {}
+
+    bool isValid() const noexcept { return map.getData() != nullptr && map.getSize() > 0; }
+
+    juce::int64 getTotalBytes() const override { return (juce::int64) map.getSize(); }
+
+    bool getNextMessage (juce::MidiMessage& message) override
+    {
+        const auto* data = static_cast<const uint8*> (map.getData());
+        const auto size = map.getSize();
+
+        while (position < size && data[position] != 0xf0)
+            ++position;
+
+        auto end = position + 1;
+        while (end < size && data[end] != 0xf7)
+            ++end;
+
+        if (end >= size)
+            return false;
+
+        // Only the packet being sent is copied, never the whole bank.
+        message = juce::MidiMessage (data + position, (int) (end - position + 1));
+        position = end + 1;
+        return true;
+    }
+
+private:
+    juce::MemoryMappedFile map;
+    size_t position = 0;
+};
+} // namespace detail
+
+//==============================================================================
+DoubleBufferedWriter::DoubleBufferedWriter (int size)
+    : juce::Thread ("VMC Librarian Writer"), bufferSize (juce::jmax (1024, size))
+{
+    for (auto& buffer : buffers)
+        buffer.malloc ((size_t) bufferSize);
+}
+
+DoubleBufferedWriter::~DoubleBufferedWriter()
+{
+    close();
+}
+
+bool DoubleBufferedWriter::open (const juce::File& file)
+{
+    close();
+
+    file.deleteFile();
+    auto newStream = std::make_unique<juce::FileOutputStream> (file);
+    if (newStream->failedToOpen())
+        return false;
+
+    stream = std::move (newStream);
+    active = fill = 0;
+    pendingIndex.store (-1);
+    bytesWritten.store (0);
+    numStalls.store (0);
+    return startThread();
+}
+
+void DoubleBufferedWriter::close()
+{
+    if (stream == nullptr)
+        return;
+
+    signalThreadShouldExit();
+    notify();
+    stopThread (5000);
+
+    if (fill > 0)
+        stream->write (buffers[active], (size_t) fill);
+    fill = 0;
+    stream->flush();
+    stream.reset();
+}
+
+void DoubleBufferedWriter::write (const uint8* data, int size)
+{
+    while (size > 0) {
+        const int numToCopy = juce::jmin (size, bufferSize - fill);
+        std::memcpy (buffers[active] + fill, data, (size_t) numToCopy);
+        fill += numToCopy;
+        data += numToCopy;
+        size -= numToCopy;
+        bytesWritten += numToCopy;
+
+        if (fill == bufferSize)
+            swapBuffers();
+    }
+}
+
+void DoubleBufferedWriter::swapBuffers()
+{
+    if (pendingIndex.load (std::memory_order_acquire) >= 0) {
+        ++numStalls;
+        while (pendingIndex.load (std::memory_order_acquire) >= 0)
+            bufferFreed.wait (50);
+    }
+
+    pendingSize.store (fill, std::memory_order_relaxed);
+    pendingIndex.store (active, std::memory_order_release);
+    active ^= 1;
+    fill = 0;
+    notify();
+}
+
+void DoubleBufferedWriter::flushPending()
+{
+    const int index = pendingIndex.load (std::memory_order_acquire);
+    if (index < 0)
+        return;
+
+    stream->write (buffers[index], (size_t) pendingSize.load (std::memory_order_relaxed));
+    pendingIndex.store (-1, std::memory_order_release);
+    bufferFreed.signal();
+}
+
+void DoubleBufferedWriter::run()
+{
+    while (! threadShouldExit()) {
+        wait (250);
+        flushPending();
+    }
+
+    flushPending();
+}
+
+//==============================================================================
+SysExLibrarian::SysExLibrarian (SysExSender::SendFunction sendFunction)
+    : sender (std::move (sendFunction))
+{
+}
+
+SysExLibrarian::~SysExLibrarian()
+{
+    stopRecording();
+    sender.cancel();
+}
+
+juce::File SysExLibrarian::getBanksPath()
+{
+    auto path = Controller::getUserDataPath().getChildFile ("SysEx");
+    if (! path.exists())
+        path.createDirectory();
+    return path;
+}
+
+bool SysExLibrarian::startRecording (const juce::String& inputIdentifier, const juce::File& file)
+{
+    stopRecording();
+
+    if (! writer.open (file))
+        return false;
+
+    messageBytesWritten = 0;
+    messagesRecorded.store (0);
+    recordStart.store (juce::Time::getMillisecondCounterHiRes());
+    recordEnd.store (0.0);
+
+    // Open the input directly, AudioDeviceManager doesn't forward partial SysEx.
+    input = juce::MidiInput::openDevice (inputIdentifier, this);
+    if (input == nullptr) {
+        writer.close();
+        return false;
+    }
+
+    recordingFile = file;
+    input->start();
+    return true;
+}
+
+void SysExLibrarian::stopRecording()
+{
+    if (input == nullptr)
+        return;
+
+    input->stop();
+    input.reset();
+    writer.close();
+    recordEnd.store (juce::Time::getMillisecondCounterHiRes());
+}
+
+double SysExLibrarian::getRecordingThroughput() const noexcept
+{
+    auto end = recordEnd.load();
+    if (end <= 0.0)
+        end = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsed = (end - recordStart.load()) * 0.001;
+    return elapsed > 0.0 ? (double) writer.getBytesWritten() / elapsed : 0.0;
+}
+
+bool SysExLibrarian::sendBank (const juce::File& file)
+{
+    auto source = std::make_unique<detail::MappedSysExSource> (file);
+    if (! source->isValid())
+        return false;
+    return sender.send (std::move (source));
+}
+
+void SysExLibrarian::handlePartialSysexMessage (juce::MidiInput*, const uint8* messageData,
+                                                int numBytesSoFar, double)
+{
+    // The data so far is handed over each time, only write what's new.
+    if (numBytesSoFar > messageBytesWritten) {
+        writer.write (messageData + messageBytesWritten, numBytesSoFar - messageBytesWritten);
+        messageBytesWritten = numBytesSoFar;
+    }
+}
+
+void SysExLibrarian::handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& message)
+{
+    if (! message.isSysEx())
+        return;
+
+    const int size = message.getRawDataSize();
+    if (size < messageBytesWritten)
+        messageBytesWritten = 0;
+
+    writer.write (message.getRawData() + messageBytesWritten, size - messageBytesWritten);
+    messageBytesWritten = 0;
+    ++messagesRecorded;
+}
+
+} // namespace vmc
@@ -0,0 +1,107 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include "sysexdump.hpp"
+
+namespace vmc {
+
+/** Writes a byte stream to disk from a background thread.
+
+    The producer fills one buffer while the writer thread flushes the other, so
+    data goes straight from the MIDI thread to the file without growing copies.
+    Only one producer thread may call write() at a time.
+*/
+class DoubleBufferedWriter final : private juce::Thread {
+public:
+    explicit DoubleBufferedWriter (int bufferSize = 64 * 1024);
+    ~DoubleBufferedWriter() override;
+
+    /** Opens a file for writing, replacing it if it exists. */
+    bool open (const juce::File& file);
+
+    /** Flushes everything written so far and closes the file. The producer
+        must have stopped writing before calling this.
+    */
+    void close();
+
+    /** Returns true if a file is open. */
+    bool isOpen() const noexcept { return stream != nullptr; }
+
+    /** Appends bytes to the stream. Only blocks if the disk falls a full
+        buffer behind.
+    */
+    void write (const uint8* data, int size);
+
+    /** Returns the total number of bytes handed to write(). */
+    juce::int64 getBytesWritten() const noexcept { return bytesWritten.load(); }
+
+    /** Returns the number of times the producer had to wait for the disk. */
+    int getNumStalls() const noexcept { return numStalls.load(); }
+
+private:
+    const int bufferSize;
+    juce::HeapBlock<uint8> buffers[2];
+    int active = 0, fill = 0;
+    std::atomic<int> pendingIndex { -1 }, pendingSize { 0 };
+    juce::WaitableEvent bufferFreed;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    std::atomic<juce::int64> bytesWritten { 0 };
+    std::atomic<int> numStalls { 0 };
+
+    void swapBuffers();
+    void flushPending();
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (DoubleBufferedWriter)
+};
+
+/** Records incoming SysEx to .syx files and sends stored banks back out. */
+class SysExLibrarian final : private juce::MidiInputCallback {
+public:
+    explicit SysExLibrarian (SysExSender::SendFunction sendFunction);
+    ~SysExLibrarian() override;
+
+    /** Returns the directory where banks are stored. */
+    static juce::File getBanksPath();
+
+    /** Opens the given MIDI input and streams its SysEx into file. */
+    bool startRecording (const juce::String& inputIdentifier, const juce::File& file);
+    /** Stops recording and closes the file. */
+    void stopRecording();
+    /** Returns true while recording. */
+    bool isRecording() const noexcept { return input != nullptr; }
+
+    /** Returns the file currently, or last, recorded to. */
+    juce::File getRecordingFile() const { return recordingFile; }
+    /** Returns the number of bytes recorded so far. */
+    juce::int64 getBytesRecorded() const noexcept { return writer.getBytesWritten(); }
+    /** Returns the number of complete SysEx messages recorded so far. */
+    int getMessagesRecorded() const noexcept { return messagesRecorded.load(); }
+    /** Returns the average bytes per second of the current or last recording. */
+    double getRecordingThroughput() const noexcept;
+
+    /** Sends the SysEx messages in a bank file. */
+    bool sendBank (const juce::File& file);
+    /** Returns the sender used for banks. */
+    SysExSender& getSender() noexcept { return sender; }
+
+private:
+    SysExSender sender;
+    DoubleBufferedWriter writer;
+    std::unique_ptr<juce::MidiInput> input;
+    juce::File recordingFile;
+    int messageBytesWritten = 0;
+    std::atomic<int> messagesRecorded { 0 };
+    std::atomic<double> recordStart { 0.0 }, recordEnd { 0.0 };
+
+    void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage&) override;
+    void handlePartialSysexMessage (juce::MidiInput*, const uint8* messageData,
+                                    int numBytesSoFar, double timestamp) override;
+
+    JUCE_DECLARE_NON_COPYABLE (SysExLibrarian)
+};
+
+} // namespace vmc
@@ -0,0 +1,219 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "librariancomponent.hpp"
+#include "controller.hpp"
+#include "librarian.hpp"
+
+namespace vmc {
+namespace detail {
+inline static void styleLibrarianButton (juce::TextButton& button, const juce::String& text)
+{
+    button.setButtonText (text);
+    button.setColour (juce::TextButton::textColourOffId, juce::Colours::white.withAlpha (0.8f));
+    button.setColour (juce::TextButton::textColourOnId, juce::Colours::white);
+}
+
+inline static void styleLibrarianLabel (juce::Label& label, const juce::String& text)
+{
+    label.setText (text, juce::dontSendNotification);
+    label.setColour (juce::Label::textColourId, juce::Colours::white.withAlpha (0.8f));
+    label.setFont (juce::Font (juce::FontOptions (12.0f)));
+}
+
+inline static juce::String describeRate (double bytesPerSecond)
+{
+    return juce::File::descriptionOfSizeInBytes ((juce::int64) bytesPerSecond) + "/s";
+}
+} // namespace detail
+
+LibrarianComponent::LibrarianComponent (Controller& c)
+    : controller (c)
+{
+    addAndMakeVisible (input);
+    input.setTooltip ("MIDI input to record from");
+
+    addAndMakeVisible (recordButton);
+    detail::styleLibrarianButton (recordButton, "Record");
+    recordButton.onClick = [this]() { toggleRecording(); };
+
+    addAndMakeVisible (bank);
+    bank.setTooltip ("Stored bank to send");
+
+    addAndMakeVisible (sendButton);
+    detail::styleLibrarianButton (sendButton, "Send");
+    sendButton.onClick = [this]() { toggleSending(); };
+
+    auto& settings = controller.getSettings();
+
+    addAndMakeVisible (packetIntervalLabel);
+    detail::styleLibrarianLabel (packetIntervalLabel, "Packet gap (ms)");
+    addAndMakeVisible (packetInterval);
+    packetInterval.setSliderStyle (juce::Slider::IncDecButtons);
+    packetInterval.setTextBoxStyle (juce::Slider::TextBoxLeft, false, 60, 24);
+    packetInterval.setRange (0.0, 1000.0, 1.0);
+    packetInterval.setValue (settings.getInt (Settings::librarianPacketInterval, 20), juce::dontSendNotification);
+    packetInterval.onValueChange = [this]() { applyPacing(); };
+
+    addAndMakeVisible (bytesPerSecondLabel);
+    detail::styleLibrarianLabel (bytesPerSecondLabel, "Max bytes/s");
+    addAndMakeVisible (bytesPerSecond);
+    bytesPerSecond.setSliderStyle (juce::Slider::IncDecButtons);
+    bytesPerSecond.setTextBoxStyle (juce::Slider::TextBoxLeft, false, 60, 24);
+    bytesPerSecond.setRange (100.0, 1000000.0, 100.0);
+    bytesPerSecond.setValue (settings.getInt (Settings::librarianBytesPerSecond, 3125), juce::dontSendNotification);
+    bytesPerSecond.onValueChange = [this]() { applyPacing(); };
+
+    addAndMakeVisible (progressBar);
+    addAndMakeVisible (status);
+    detail::styleLibrarianLabel (status, {});
+
+    updateInputs();
+    updateBanks();
+    applyPacing();
+    startTimerHz (10);
+    setSize (480, 170);
+}
+
+LibrarianComponent::~LibrarianComponent()
+{
+    stopTimer();
+}
+
+void LibrarianComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour::fromRGB (45, 48, 52));
+}
+
+void LibrarianComponent::resized()
+{
+    auto r = getLocalBounds().reduced (8);
+
+    auto row = r.removeFromTop (24);
+    recordButton.setBounds (row.removeFromRight (80));
+    row.removeFromRight (6);
+    input.setBounds (row);
+    r.removeFromTop (6);
+
+    row = r.removeFromTop (24);
+    sendButton.setBounds (row.removeFromRight (80));
+    row.removeFromRight (6);
+    bank.setBounds (row);
+    r.removeFromTop (6);
+
+    row = r.removeFromTop (24);
+    packetIntervalLabel.setBounds (row.removeFromLeft (100));
+    packetInterval.setBounds (row.removeFromLeft (120));
+    row.removeFromLeft (10);
+    bytesPerSecondLabel.setBounds (row.removeFromLeft (80));
+    bytesPerSecond.setBounds (row.removeFromLeft (140));
+    r.removeFromTop (6);
+
+    progressBar.setBounds (r.removeFromTop (20));
+    r.removeFromTop (4);
+    status.setBounds (r.removeFromTop (22));
+}
+
+void LibrarianComponent::updateInputs()
+{
+    inputs = juce::MidiInput::getAvailableDevices();
+    input.clear (juce::dontSendNotification);
+    for (int i = 0; i < inputs.size(); ++i)
+        input.addItem (inputs.getReference (i).name, i + 1);
+    if (inputs.size() > 0)
+        input.setSelectedItemIndex (0, juce::dontSendNotification);
+}
+
+void LibrarianComponent::updateBanks()
+{
+    const auto selected = bank.getText();
+    banks = SysExLibrarian::getBanksPath().findChildFiles (juce::File::findFiles, false, "*.syx");
+    banks.sort();
+
+    bank.clear (juce::dontSendNotification);
+    for (int i = 0; i < banks.size(); ++i)
+        bank.addItem (banks.getReference (i).getFileName(), i + 1);
+
+    bank.setText (selected, juce::dontSendNotification);
+    if (bank.getSelectedId() == 0 && banks.size() > 0)
+        bank.setSelectedItemIndex (banks.size() - 1, juce::dontSendNotification);
+}
+
+void LibrarianComponent::toggleRecording()
+{
+    auto& librarian = controller.getLibrarian();
+    if (librarian.isRecording()) {
+        librarian.stopRecording();
+        updateBanks();
+        return;
+    }
+
+    const int index = input.getSelectedItemIndex();
+    if (! juce::isPositiveAndBelow (index, inputs.size()))
+        return;
+
+    const auto name = juce::Time::getCurrentTime().formatted ("Bank %Y-%m-%d %H%M%S");
+    const auto file = SysExLibrarian::getBanksPath().getNonexistentChildFile (name, ".syx", false);
+    if (! librarian.startRecording (inputs.getReference (index).identifier, file))
+        status.setText ("Could not open " + inputs.getReference (index).name, juce::dontSendNotification);
+}
+
+void LibrarianComponent::toggleSending()
+{
+    auto& librarian = controller.getLibrarian();
+    if (librarian.getSender().isSending()) {
+        librarian.getSender().cancel();
+        return;
+    }
+
+    const int index = bank.getSelectedItemIndex();
+    if (juce::isPositiveAndBelow (index, banks.size()) && ! librarian.sendBank (banks.getReference (index)))
+        status.setText ("Could not send " + banks.getReference (index).getFileName(), juce::dontSendNotification);
+}
+
+void LibrarianComponent::applyPacing()
+{
+    const int interval = juce::roundToInt (packetInterval.getValue());
+    const int rate = juce::roundToInt (bytesPerSecond.getValue());
+
+    auto& sender = controller.getLibrarian().getSender();
+    sender.setPacketInterval (interval);
+    sender.setBytesPerSecond (rate);
+
+    auto& settings = controller.getSettings();
+    settings.set (Settings::librarianPacketInterval, interval);
+    settings.set (Settings::librarianBytesPerSecond, rate);
+}
+
+void LibrarianComponent::timerCallback()
+{
+    auto& librarian = controller.getLibrarian();
+    auto& sender = librarian.getSender();
+    const bool recording = librarian.isRecording();
+    const bool sending = sender.isSending();
+
+    recordButton.setButtonText (recording ? "Stop" : "Record");
+    sendButton.setButtonText (sending ? "Cancel" : "Send");
+    input.setEnabled (! recording);
+    bank.setEnabled (! sending);
+
+    if (recording) {
+        progress = -1.0; // indeterminate
+        status.setText (juce::String ("Recording: ")
+                            + juce::File::descriptionOfSizeInBytes (librarian.getBytesRecorded())
+                            + ", " + juce::String (librarian.getMessagesRecorded()) + " messages, "
+                            + detail::describeRate (librarian.getRecordingThroughput()),
+                        juce::dontSendNotification);
+    } else if (sending || sender.getBytesSent() > 0) {
+        progress = sender.getProgress();
+        status.setText (juce::String (sending ? "Sending: " : "Sent: ")
+                            + juce::File::descriptionOfSizeInBytes (sender.getBytesSent()) + " of "
+                            + juce::File::descriptionOfSizeInBytes (sender.getTotalBytes()) + ", "
+                            + detail::describeRate (sender.getThroughput()),
+                        juce::dontSendNotification);
+    } else {
+        progress = 0.0;
+    }
+}
+
+} // namespace vmc
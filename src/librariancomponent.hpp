@@ -0,0 +1,47 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace vmc {
+
+class Controller;
+
+/** Records SysEx dumps from a MIDI input and sends stored banks back. */
+class LibrarianComponent : public juce::Component,
+                           private juce::Timer {
+public:
+    LibrarianComponent (Controller& controller);
+    ~LibrarianComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    Controller& controller;
+    juce::ComboBox input;
+    juce::TextButton recordButton;
+    juce::ComboBox bank;
+    juce::TextButton sendButton;
+    juce::Slider packetInterval, bytesPerSecond;
+    juce::Label packetIntervalLabel, bytesPerSecondLabel;
+    double progress = 0.0;
+    juce::ProgressBar progressBar { progress };
+    juce::Label status;
+    juce::Array<juce::MidiDeviceInfo> inputs;
+    juce::Array<juce::File> banks;
+
+    void updateInputs();
+    void updateBanks();
+    void toggleRecording();
+    void toggleSending();
+    void applyPacing();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LibrarianComponent)
+};
+
+} // namespace vmc
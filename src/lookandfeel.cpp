@@ -12,10 +12,48 @@ LookAndFeel::LookAndFeel()
     setColour (TextButton::buttonColourId, Colour::fromRGB (42, 42, 42));
 }
 
+template <typename PaintFunction>
+const juce::Image& LookAndFeel::getCachedImage (CachedPart part, juce::Rectangle<float> size, float scale,
+                                                PaintFunction&& paint)
+{
+    for (const auto& cached : imageCache)
+        if (cached.part == part && cached.size == size && cached.scale == scale)
+            return cached.image;
+
+    // Sizes only change on resize, don't let stale ones pile up.
+    if (imageCache.size() >= 32)
+        imageCache.clear();
+
+    juce::Image image (juce::Image::ARGB,
+                       juce::jmax (1, juce::roundToInt (size.getWidth() * scale)),
+                       juce::jmax (1, juce::roundToInt (size.getHeight() * scale)),
+                       true);
+    {
+        juce::Graphics ig (image);
+        ig.addTransform (juce::AffineTransform::scale (scale));
+        paint (ig, size);
+    }
+
+    imageCache.push_back ({ part, size, scale, image });
+    return imageCache.back().image;
+}
+
+void LookAndFeel::drawCachedImage (juce::Graphics& g, const juce::Image& image,
+                                   juce::Point<float> topLeft, float scale)
+{
+    // Snap to physical pixels so the image is copied, not resampled.
+    const auto x = std::round (topLeft.x * scale) / scale;
+    const auto y = std::round (topLeft.y * scale) / scale;
+    g.setOpacity (1.0f);
+    g.drawImageTransformed (image, juce::AffineTransform::scale (1.0f / scale).translated (x, y));
+}
+
 void LookAndFeel::drawLinearSlider (juce::Graphics& g, int x, int y, int width, int height,
                                     float sliderPos, float minSliderPos, float maxSliderPos,
                                     const juce::Slider::SliderStyle style, juce::Slider& slider)
 {
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
     // Draw the track
     auto trackWidth = 6.0f;
     juce::Rectangle<float> track;
@@ -24,9 +62,7 @@ void LookAndFeel::drawLinearSlider (juce::Graphics& g, int x, int y, int width,
     else
         track = juce::Rectangle<float> (x, y + height * 0.5f - trackWidth * 0.5f, (float) width, trackWidth);
 
-    // Track background (matching rotary inner color)
-    g.setColour (juce::Colour::fromRGB (42, 42, 42));
-    g.fillRoundedRectangle (track, 3.0f);
+    drawCachedImage (g, getCachedImage (faderTrack, track.withZeroOrigin(), scale, paintFaderTrack), track.getPosition(), scale);
 
     // Draw the fader cap (handle)
     float faderWidth = (style == juce::Slider::LinearVertical) ? width * 0.8f : 18.0f;
@@ -38,6 +74,19 @@ void LookAndFeel::drawLinearSlider (juce::Graphics& g, int x, int y, int width,
     else
         fader = juce::Rectangle<float> (sliderPos - faderWidth * 0.5f, y + (height - faderHeight) * 0.5f, faderWidth, faderHeight);
 
+    // The whole cap moves with the value, it is a single blit.
+    drawCachedImage (g, getCachedImage (faderCap, fader.withZeroOrigin(), scale, paintFaderCap), fader.getPosition(), scale);
+}
+
+void LookAndFeel::paintFaderTrack (juce::Graphics& g, juce::Rectangle<float> track)
+{
+    // Track background (matching rotary inner color)
+    g.setColour (juce::Colour::fromRGB (42, 42, 42));
+    g.fillRoundedRectangle (track, 3.0f);
+}
+
+void LookAndFeel::paintFaderCap (juce::Graphics& g, juce::Rectangle<float> fader)
+{
     // Fader body (darker outer ring like rotary)
     g.setColour (juce::Colour::fromRGB (28, 28, 28));
     g.fillRoundedRectangle (fader, 4.0f);
@@ -71,21 +120,9 @@ void LookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width,
     auto radius = juce::jmin (bounds.getWidth(), bounds.getHeight()) * 0.5f;
     auto centre = bounds.getCentre();
 
-    // Outer ring
-    g.setColour (juce::Colour::fromRGB (28, 28, 28));
-    g.fillEllipse (bounds);
-
-    // Inner circle (slightly smaller)
-    auto innerBounds = bounds.reduced (3.0f);
-    g.setColour (juce::Colour::fromRGB (42, 42, 42));
-    g.fillEllipse (innerBounds);
-
-    // Subtle radial gradient for depth
-    juce::ColourGradient grad (
-        juce::Colours::black.withAlpha (0.15f), centre.x, centre.y, juce::Colours::transparentBlack, centre.x + radius, centre.y + radius,
-        true); // true = radial gradient
-    g.setGradientFill (grad);
-    g.fillEllipse (innerBounds);
+    // The body doesn't change with the value, blit it from the cache.
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    drawCachedImage (g, getCachedImage (dialBody, bounds.withZeroOrigin(), scale, paintDialBody), bounds.getPosition(), scale);
 
     // Calculate indicator position
     float angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
@@ -109,6 +146,28 @@ void LookAndFeel::drawRotarySlider (juce::Graphics& g, int x, int y, int width,
                    highlightSize);
 }
 
+void LookAndFeel::paintDialBody (juce::Graphics& g, juce::Rectangle<float> bounds)
+{
+    auto radius = juce::jmin (bounds.getWidth(), bounds.getHeight()) * 0.5f;
+    auto centre = bounds.getCentre();
+
+    // Outer ring
+    g.setColour (juce::Colour::fromRGB (28, 28, 28));
+    g.fillEllipse (bounds);
+
+    // Inner circle (slightly smaller)
+    auto innerBounds = bounds.reduced (3.0f);
+    g.setColour (juce::Colour::fromRGB (42, 42, 42));
+    g.fillEllipse (innerBounds);
+
+    // Subtle radial gradient for depth
+    juce::ColourGradient grad (
+        juce::Colours::black.withAlpha (0.15f), centre.x, centre.y, juce::Colours::transparentBlack, centre.x + radius, centre.y + radius,
+        true); // true = radial gradient
+    g.setGradientFill (grad);
+    g.fillEllipse (innerBounds);
+}
+
 void LookAndFeel::drawComboBox (juce::Graphics& g, int width, int height, bool isButtonDown,
                                 int buttonX, int buttonY, int buttonW, int buttonH,
                                 juce::ComboBox& box)
@@ -36,6 +36,34 @@ public:
                          bool shouldDrawButtonAsDown) override;
 
     void drawPopupMenuBackground (juce::Graphics&, int width, int height) override;
+
+private:
+    enum CachedPart {
+        dialBody = 0,
+        faderTrack,
+        faderCap
+    };
+
+    struct CachedImage {
+        CachedPart part;
+        juce::Rectangle<float> size;
+        float scale;
+        juce::Image image;
+    };
+
+    // Static parts of sliders rendered once per size and display scale, so a
+    // moving slider only blits them and draws its indicator.
+    std::vector<CachedImage> imageCache;
+
+    template <typename PaintFunction>
+    const juce::Image& getCachedImage (CachedPart part, juce::Rectangle<float> size, float scale,
+                                       PaintFunction&& paint);
+    static void drawCachedImage (juce::Graphics& g, const juce::Image& image,
+                                 juce::Point<float> topLeft, float scale);
+
+    static void paintDialBody (juce::Graphics& g, juce::Rectangle<float> bounds);
+    static void paintFaderTrack (juce::Graphics& g, juce::Rectangle<float> track);
+    static void paintFaderCap (juce::Graphics& g, juce::Rectangle<float> fader);
 };
 
 } // namespace vmc
@@ -1,12 +1,20 @@
 // Copyright 2025 (c) Kushview, LLC
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <iostream>
+
 #include <juce_gui_basics/juce_gui_basics.h>
 
 #include "device.hpp"
 #include "maincomponent.hpp"
 #include "lookandfeel.hpp"
 #include "controller.hpp"
+#include "headless.hpp"
+#include "pluginscanner.hpp"
+#include "qwertyinput.hpp"
+#include "sharedmidiring.hpp"
+#include "stallwatchdog.hpp"
+#include "tracing.hpp"
 
 using namespace juce;
 
@@ -17,25 +25,59 @@ public:
 
     const String getApplicationName() override { return "Virtual MIDI Controller"; }
     const String getApplicationVersion() override { return VMC_VERSION_STRING; }
-    bool moreThanOneInstanceAllowed() override { return false; }
+    bool moreThanOneInstanceAllowed() override
+    {
+        // Plugin scans run in copies of VMC alongside the main one.
+        return getCommandLineParameters().contains ("--scan-plugin");
+    }
 
     void initialise (const String& commandLine) override
     {
-        ignoreUnused (commandLine);
-        setupGlobals();
+        if (commandLine.contains ("--scan-plugin")) {
+            // Parsed from the original arguments, as plugin paths may have spaces.
+            const ArgumentList scanArgs ("virtual-midi-controller", getCommandLineParameterArray());
+            setApplicationReturnValue (PluginScanner::scanInChildProcess (scanArgs));
+            quit();
+            return;
+        }
+
+        const ArgumentList args ("virtual-midi-controller", StringArray::fromTokens (commandLine, true));
+        startTraceRecording (args);
 
-        LookAndFeel::setDefaultLookAndFeel (&look);
+        if (args.containsOption ("--headless")) {
+            initialiseHeadless (args);
+            return;
+        }
+
+        setupGlobals (args);
+        startOscServer (args);
+        openSharedMidiRing (args);
+        startStallWatchdog (args);
+
+        look = std::make_unique<vmc::LookAndFeel>();
+        LookAndFeel::setDefaultLookAndFeel (look.get());
         mainWindow.reset (new MainWindow (getApplicationName(), *controller));
         tooltipWindow.reset (new TooltipWindow (mainWindow.get()));
+
+        // Load the last device once the window is up, the UI follows deviceChanged().
+        MessageManager::callAsync ([this]() {
+            if (controller != nullptr)
+                controller->restoreSettings();
+        });
     }
 
     void shutdown() override
     {
+        if (controller == nullptr)
+            return;
+
         controller->saveSettings();
+        headless.reset();
         shutdownGui();
 
         controller->shutdown();
         controller.reset();
+        stopTraceRecording();
     }
 
     void systemRequestedQuit() override
@@ -45,7 +87,10 @@ public:
 
     void anotherInstanceStarted (const String& commandLine) override
     {
-        ignoreUnused (commandLine);
+        // Lets a second invocation drive this one, e.g. --exec="note 60; off 60"
+        const ArgumentList args ("virtual-midi-controller", StringArray::fromTokens (commandLine, true));
+        if (headless != nullptr && args.containsOption ("--exec"))
+            std::cout << headless->getCommands().executeAll (args.getValueForOption ("--exec").unquoted()) << std::endl;
     }
 
     class MainWindow : public DocumentWindow,
@@ -54,8 +99,10 @@ public:
         MainWindow (String name, Controller& vc)
             : DocumentWindow (name, Desktop::getInstance().getDefaultLookAndFeel().findColour (ResizableWindow::backgroundColourId),
                               DocumentWindow::closeButton | DocumentWindow::minimiseButton),
-              controller (vc)
+              controller (vc),
+              qwertyInput (vc)
         {
+            addKeyListener (&qwertyInput);
             controller.addListener (this);
 #if JUCE_LINUX
             setUsingNativeTitleBar (false);
@@ -81,6 +128,7 @@ public:
 
         ~MainWindow() override
         {
+            removeKeyListener (&qwertyInput);
             controller.removeListener (this);
             clearContentComponent();
             setConstrainer (nullptr);
@@ -106,6 +154,13 @@ public:
             return;
         }
 
+        void activeWindowStatusChanged() override
+        {
+            // Key releases aren't seen once the window loses focus.
+            if (! isActiveWindow())
+                qwertyInput.releaseAll();
+        }
+
         void deviceChanged() override
         {
             auto name = controller.device().name().trim();
@@ -116,21 +171,115 @@ public:
 
     private:
         Controller& controller;
+        vmc::QwertyNoteInput qwertyInput;
         ComponentBoundsConstrainer constrain;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainWindow)
     };
 
 private:
-    vmc::LookAndFeel look;
+    std::unique_ptr<vmc::LookAndFeel> look;
     std::unique_ptr<MainWindow> mainWindow;
     std::unique_ptr<Controller> controller;
     std::unique_ptr<TooltipWindow> tooltipWindow; // Add TooltipWindow instance
+    std::unique_ptr<HeadlessServer> headless;
+    File traceFile;
+
+    void setupGlobals (const ArgumentList& args)
+    {
+        controller.reset (new Controller());
+        // --midi-only or the saved choice leaves the audio device closed.
+        controller->setMidiOnly (args.containsOption ("--midi-only")
+                                 || controller->getSettings().getInt (Settings::midiOnly, 0) != 0);
+        controller->initializeAudioDeviceAsync();
+    }
 
-    void setupGlobals()
+    void initialiseHeadless (const ArgumentList& args)
     {
         controller.reset (new Controller());
         controller->restoreSettings();
-        controller->initializeAudioDevice();
+        controller->initializeMidiDevices();
+        startOscServer (args);
+        openSharedMidiRing (args);
+        startStallWatchdog (args);
+
+        if (args.containsOption ("--device")) {
+            const auto path = args.getValueForOption ("--device").unquoted();
+            const auto file = File::getCurrentWorkingDirectory().getChildFile (path);
+            if (! controller->loadDeviceFile (file))
+                std::cerr << "vmc: could not load " << file.getFullPathName() << std::endl;
+        }
+
+        HeadlessServer::Options options;
+        options.readStdin = ! args.containsOption ("--no-stdin");
+        if (args.containsOption ("--port")) {
+            const int port = args.getValueForOption ("--port").getIntValue();
+            options.port = port > 0 ? port : HeadlessServer::defaultPort;
+        }
+
+        headless = std::make_unique<HeadlessServer> (*controller, options);
+        headless->getCommands().onQuit = [this]() { systemRequestedQuit(); };
+
+        if (args.containsOption ("--exec"))
+            std::cout << headless->getCommands().executeAll (args.getValueForOption ("--exec").unquoted()) << std::endl;
+    }
+
+    /** Records a trace from startup to quit when --trace=FILE is given. */
+    void startTraceRecording (const ArgumentList& args)
+    {
+        if (! args.containsOption ("--trace"))
+            return;
+
+        const auto path = args.getValueForOption ("--trace").unquoted();
+        traceFile = File::getCurrentWorkingDirectory().getChildFile (path.isNotEmpty() ? path : "vmc-trace.json");
+        TraceRecorder::start();
+    }
+
+    void stopTraceRecording()
+    {
+        if (traceFile == File())
+            return;
+
+        TraceRecorder::stop();
+        if (! TraceRecorder::writeChromeJson (traceFile))
+            std::cerr << "vmc: could not write " << traceFile.getFullPathName() << std::endl;
+    }
+
+    void startOscServer (const ArgumentList& args)
+    {
+        int port = controller->getSettings().getInt (Settings::oscPort, 0);
+        if (args.containsOption ("--osc-port"))
+            port = args.getValueForOption ("--osc-port").getIntValue();
+        if (port > 0 && ! controller->startOscServer (port))
+            std::cerr << "vmc: could not listen for OSC on port " << port << std::endl;
+    }
+
+    void openSharedMidiRing (const ArgumentList& args)
+    {
+        if (! args.containsOption ("--shm-ring"))
+            return;
+        auto name = args.getValueForOption ("--shm-ring");
+        if (name.isEmpty())
+            name = vmc::SharedMidiRing::defaultName;
+        if (! controller->openSharedMidiRing (name))
+            std::cerr << "vmc: could not create the shared MIDI ring " << name << std::endl;
+    }
+
+    /** Logs message thread stalls when --watchdog[=MS] is given or it was left on. */
+    void startStallWatchdog (const ArgumentList& args)
+    {
+        auto& settings = controller->getSettings();
+        int threshold = settings.getInt (Settings::stallThreshold, StallWatchdog::defaultThreshold);
+        if (args.containsOption ("--watchdog")) {
+            const int value = args.getValueForOption ("--watchdog").getIntValue();
+            if (value > 0)
+                threshold = value;
+        } else if (settings.getInt (Settings::stallWatchdog, 0) == 0) {
+            return;
+        }
+
+        const auto file = StallWatchdog::getDefaultLogFile();
+        if (! controller->getStallWatchdog().start (threshold, file))
+            std::cerr << "vmc: could not write " << file.getFullPathName() << std::endl;
     }
 
     void shutdownGui()
@@ -142,6 +291,7 @@ private:
         }
 
         LookAndFeel::setDefaultLookAndFeel (nullptr);
+        look.reset();
     }
 };
 } // namespace vmc
@@ -4,6 +4,17 @@
 #include "maincomponent.hpp"
 #include "virtualkeyboard.hpp"
 #include "controller.hpp"
+#include "controlrefresher.hpp"
+#include "engine.hpp"
+#include "sampleplayer.hpp"
+#include "latencytracer.hpp"
+#include "latencytracercomponent.hpp"
+#include "librariancomponent.hpp"
+#include "paintstats.hpp"
+#include "pluginchaincomponent.hpp"
+#include "stallwatchdog.hpp"
+#include "stressgeneratorcomponent.hpp"
+#include "tracing.hpp"
 #include "BinaryData.h"
 
 namespace vmc {
@@ -12,6 +23,23 @@ inline static juce::Colour baseWindowColor()
 {
     return juce::Colour::fromRGB (45, 48, 52);
 }
+/** A window for a tool panel that hides rather than closes. */
+class ToolWindow : public juce::DocumentWindow {
+public:
+    ToolWindow (const juce::String& title, juce::Component* content)
+        : juce::DocumentWindow (title, baseWindowColor(), juce::DocumentWindow::closeButton)
+    {
+        setUsingNativeTitleBar (true);
+        setContentOwned (content, true);
+        setResizable (false, false);
+    }
+
+    void closeButtonPressed() override
+    {
+        setVisible (false);
+    }
+};
+
 inline static void styleIncDecSlider (juce::Slider& s, bool readOnly = false)
 {
     s.setSliderStyle (Slider::IncDecButtons);
@@ -26,7 +54,15 @@ CCDial::CCDial (Controller& c) : _controller (c)
     setTextBoxStyle (juce::Slider::NoTextBox, true, 10, 10);
 }
 
-class MainComponent::Content : public Component {
+void CCDial::paint (juce::Graphics& g)
+{
+    VMC_TRACE_SCOPE ("CCDial::paint");
+    ScopedPaintTimer timer (_paintStats);
+    juce::Slider::paint (g);
+}
+
+class MainComponent::Content : public Component,
+                               public Controller::Listener {
 public:
     Content (MainComponent& o)
         : owner (o),
@@ -87,6 +123,12 @@ public:
         loadButton.setColour (juce::TextButton::textColourOnId, juce::Colours::white);
         loadButton.onClick = [this]() { loadDevice(); };
 
+        addAndMakeVisible (toolsButton);
+        toolsButton.setButtonText ("Tools");
+        toolsButton.setColour (juce::TextButton::textColourOffId, juce::Colours::white.withAlpha (0.8f));
+        toolsButton.setColour (juce::TextButton::textColourOnId, juce::Colours::white);
+        toolsButton.onClick = [this]() { showToolsMenu(); };
+
         addAndMakeVisible (aboutButton);
         aboutButton.setButtonText ("About");
         aboutButton.setColour (juce::TextButton::textColourOffId, juce::Colours::white.withAlpha (0.8f));
@@ -116,14 +158,16 @@ public:
 
         addAndMakeVisible (output);
         output.setTooltip ("MIDI output device");
+        // Enabled once the devices have been opened in the background.
+        output.setEnabled (false);
         output.onChange = [this]() {
-            auto& devices = owner.controller.getDeviceManager();
+            auto& controller = owner.controller;
 
             if (output.getSelectedId() == 1)
-                devices.setDefaultMidiOutputDevice (String());
+                controller.setDefaultMidiOutput (String());
             else {
                 const auto info = _devices[output.getSelectedId() - 1000];
-                devices.setDefaultMidiOutputDevice (info.identifier);
+                controller.setDefaultMidiOutput (info.identifier);
             }
         };
 
@@ -137,11 +181,14 @@ public:
             dial->setMidiChannel (midiChannel);
         }
 
+        refresher.setLatencyTracer (&owner.controller.getLatencyTracer());
+        owner.controller.addListener (this);
         setSize (VMC_WIDTH, VMC_HEIGHT);
     }
 
     ~Content()
     {
+        owner.controller.removeListener (this);
         slider1.onValueChange = nullptr;
         slider2.onValueChange = nullptr;
         slider3.onValueChange = nullptr;
@@ -150,10 +197,29 @@ public:
         output.onChange = nullptr;
     }
 
-    void updateWithSettings()
+    void deviceChanged() override
     {
-        auto& settings = owner.controller.getSettings();
+        // The controller replaced the device's data, rebind the controls.
+        device = {};
+        setDevice (owner.controller.device());
+    }
+
+    void devicesReady() override
+    {
+        updateMidiOutputs();
+        updateSelectedOutput();
+        output.setEnabled (true);
+    }
+
+    void midiOutputsChanged (const juce::Array<juce::MidiDeviceInfo>&,
+                             const juce::Array<juce::MidiDeviceInfo>&) override
+    {
+        updateMidiOutputs();
+        updateSelectedOutput();
+    }
 
+    void updateSelectedOutput()
+    {
         const String ID = owner.controller.getDeviceManager().getDefaultMidiOutputIdentifier();
         if (ID.isEmpty()) {
             output.setSelectedItemIndex (0, dontSendNotification);
@@ -172,7 +238,11 @@ public:
                 output.setSelectedItemIndex (0, dontSendNotification);
             }
         }
+    }
 
+    void updateWithSettings()
+    {
+        auto& settings = owner.controller.getSettings();
         if (settings.getValue (Settings::currentDrawer) == "ccEditor") {
             juce::Component::SafePointer<MainComponent> ptr (&this->owner);
             juce::Timer::callAfterDelay (14, [ptr, this] {
@@ -187,6 +257,31 @@ public:
 
     void paint (Graphics& g) override
     {
+        VMC_TRACE_SCOPE ("Content::paint");
+        ScopedPaintTimer timer (paintStats);
+
+        // Rendered once per size and display scale, afterwards paint is a single blit.
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (! background.isValid() || backgroundScale != scale
+            || background.getWidth() != juce::roundToInt ((float) getWidth() * scale)
+            || background.getHeight() != juce::roundToInt ((float) getHeight() * scale)) {
+            renderBackground (scale);
+        }
+
+        g.drawImageTransformed (background, juce::AffineTransform::scale (1.0f / backgroundScale));
+    }
+
+    /** Draws the brushed aluminum panel and logo at the given scale. */
+    void renderBackground (float scale)
+    {
+        backgroundScale = scale;
+        background = juce::Image (juce::Image::RGB,
+                                  juce::jmax (1, juce::roundToInt ((float) getWidth() * scale)),
+                                  juce::jmax (1, juce::roundToInt ((float) getHeight() * scale)),
+                                  false);
+
+        juce::Graphics g (background);
+        g.addTransform (juce::AffineTransform::scale (scale));
         auto bounds = getLocalBounds();
 
         // Base aluminum color
@@ -215,11 +310,11 @@ public:
         g.setColour (juce::Colours::black.withAlpha (0.15f));
         g.drawRect (bounds);
 
-        // Draw logo centered at top
+        // Draw logo centered at top, resampled from the original each time
         if (logo.isValid()) {
             const int logoHeight = 40;
             const int logoWidth = (int) ((float) logoHeight * logo.getWidth() / logo.getHeight());
-            logo = logo.rescaled (logoWidth, logoHeight, juce::Graphics::ResamplingQuality::highResamplingQuality);
+            g.setImageResamplingQuality (juce::Graphics::highResamplingQuality);
             g.drawImageWithin (logo,
                                bounds.getCentreX() - logoWidth / 2,
                                4, // Top margin
@@ -232,6 +327,8 @@ public:
 
     void resized() override
     {
+        background = {};
+
         auto r = getLocalBounds().reduced (4);
         auto r2 = r.removeFromTop (22);
         channel.setBounds (r2.removeFromLeft (90));
@@ -243,6 +340,7 @@ public:
         aboutButton.setBounds (r2.removeFromRight (70));
         loadButton.setBounds (r2.removeFromRight (70));
         saveButton.setBounds (r2.removeFromRight (70));
+        toolsButton.setBounds (r2.removeFromRight (70));
 
         auto r3 = r.removeFromBottom (180);
         slider1.setBounds (r3.removeFromLeft (30));
@@ -260,8 +358,8 @@ public:
 
     void updateMidiOutputs()
     {
-        _devices.clear();
-        _devices = MidiOutput::getAvailableDevices();
+        VMC_TRACE_SCOPE ("Content::updateMidiOutputs");
+        _devices = owner.controller.getMidiOutputs();
 
         output.clear (dontSendNotification);
         output.addItem ("None", 1);
@@ -269,11 +367,12 @@ public:
 
         int index = 0;
         for (const auto& info : _devices)
-            output.addItem (info.name, 1000 + index);
+            output.addItem (info.name, 1000 + index++);
     }
 
     void setDevice (const Device& newDev)
     {
+        VMC_TRACE_SCOPE ("Content::setDevice");
         if (device == newDev)
             return;
         device = newDev;
@@ -283,30 +382,12 @@ public:
             channel.getValueObject().referTo (midiChannelValue);
             program.getValueObject().referTo (midiProgramValue);
 
-            if (dialValues.size() != (size_t) _dials.size())
-                dialValues.resize (_dials.size());
-
-            const auto dialsTree = device.dials();
-            for (int i = 0; i < _dials.size(); ++i) {
-                auto child = dialsTree.getChild (i);
-                if (child.isValid()) {
-                    dialValues[(size_t) i] = child.getPropertyAsValue ("value", nullptr);
-                    _dials.getUnchecked (i)->getValueObject().referTo (dialValues[(size_t) i]);
-                }
-            }
-
-            if (faderValues.size() != 3u)
-                faderValues.resize (3u);
-
-            juce::Slider* faders[] = { &slider1, &slider2, &slider3 };
-            const auto fadersTree = device.faders();
-            for (int i = 0; i < 3; ++i) {
-                auto child = fadersTree.getChild (i);
-                if (child.isValid()) {
-                    faderValues[(size_t) i] = child.getPropertyAsValue ("value", nullptr);
-                    faders[i]->getValueObject().referTo (faderValues[(size_t) i]);
-                }
-            }
+            // Dials and faders may move many times a frame from MIDI or OSC,
+            // they are refreshed once per frame instead of on every change.
+            juce::Array<juce::Slider*> dials;
+            for (auto* dial : _dials)
+                dials.add (dial);
+            refresher.bind (device, dials, { &slider1, &slider2, &slider3 });
         }
     }
 
@@ -326,6 +407,7 @@ public:
                 if (file == juce::File())
                     return;
 
+                VMC_TRACE_SCOPE ("Content::saveDevice");
                 auto fileWithExt = file.hasFileExtension (".vmc") ? file : file.withFileExtension (".vmc");
                 device.save (fileWithExt);
             });
@@ -361,6 +443,203 @@ public:
             });
     }
 
+    void showToolsMenu()
+    {
+        enum MenuItems {
+            sendDeviceDumpItem = 1,
+            librarianItem,
+            paintProfilerItem,
+            exportPaintProfileItem,
+            keyboardSpritesItem,
+            latencyTracerItem,
+            recordTraceItem,
+            stressGeneratorItem,
+            stallWatchdogItem,
+            monitorItem,
+            samplesItem,
+            midiOnlyItem,
+            pluginsItem
+        };
+
+        auto& controller = owner.controller;
+        juce::PopupMenu menu;
+        menu.addItem (sendDeviceDumpItem, "Send Device Dump", ! controller.isSendingDeviceDump());
+        menu.addItem (librarianItem, "SysEx Librarian...");
+        menu.addItem (stressGeneratorItem, "Stress Generator...");
+        menu.addItem (pluginsItem, "MIDI Plugins...");
+        menu.addItem (monitorItem, "Monitor Locally", controller.areDevicesReady() && ! controller.isMidiOnly(),
+                      controller.getEngine().isMonitoring());
+        menu.addItem (samplesItem, "Play Samples Folder", controller.getEngine().isMonitoring(),
+                      controller.getEngine().getInstrument() == Engine::samplePlayer);
+        menu.addItem (midiOnlyItem, "MIDI Only (Low Power)", controller.areDevicesReady(), controller.isMidiOnly());
+        menu.addSeparator();
+        menu.addItem (paintProfilerItem, "Paint Profiler", true, owner.isPaintProfilerVisible());
+        menu.addItem (exportPaintProfileItem, "Export Paint Profile...");
+        menu.addItem (keyboardSpritesItem, "Keyboard Sprites", true,
+                      keyboard.getMidiKeyboardComponent().isUsingSprites());
+        menu.addItem (latencyTracerItem, "Latency Tracer...");
+        menu.addItem (recordTraceItem, TraceRecorder::isRecording() ? "Stop Trace Recording..." : "Record Trace",
+                      true, TraceRecorder::isRecording());
+        menu.addItem (stallWatchdogItem, "Stall Watchdog", true, controller.getStallWatchdog().isRunning());
+
+        juce::Component::SafePointer<Content> ptr (this);
+        menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (&toolsButton),
+                            [ptr] (int result) {
+                                if (ptr == nullptr)
+                                    return;
+                                if (result == sendDeviceDumpItem)
+                                    ptr->owner.controller.sendDeviceDump();
+                                else if (result == librarianItem)
+                                    ptr->showLibrarian();
+                                else if (result == paintProfilerItem)
+                                    ptr->owner.setPaintProfilerVisible (! ptr->owner.isPaintProfilerVisible());
+                                else if (result == exportPaintProfileItem)
+                                    ptr->owner.exportPaintProfile();
+                                else if (result == keyboardSpritesItem)
+                                    ptr->toggleKeyboardSprites();
+                                else if (result == latencyTracerItem)
+                                    ptr->showLatencyTracer();
+                                else if (result == recordTraceItem)
+                                    ptr->toggleTraceRecording();
+                                else if (result == stressGeneratorItem)
+                                    ptr->showStressGenerator();
+                                else if (result == stallWatchdogItem)
+                                    ptr->toggleStallWatchdog();
+                                else if (result == monitorItem)
+                                    ptr->toggleMonitoring();
+                                else if (result == samplesItem)
+                                    ptr->toggleSamples();
+                                else if (result == midiOnlyItem)
+                                    ptr->toggleMidiOnly();
+                                else if (result == pluginsItem)
+                                    ptr->showPlugins();
+                            });
+    }
+
+    /** Switches keyboard sprites on or off to compare paint times. */
+    void toggleKeyboardSprites()
+    {
+        auto& kb = keyboard.getMidiKeyboardComponent();
+        kb.setUseSprites (! kb.isUsingSprites());
+        kb.getPaintStats().reset();
+    }
+
+    /** Starts recording a trace, or stops and asks where to save it. */
+    void toggleTraceRecording()
+    {
+        if (! TraceRecorder::isRecording()) {
+            TraceRecorder::start();
+            return;
+        }
+
+        TraceRecorder::stop();
+        const auto name = juce::Time::getCurrentTime().formatted ("vmc-trace-%Y%m%d-%H%M%S.json");
+        fileChooser = std::make_unique<juce::FileChooser> (
+            "Save Trace",
+            Controller::getUserDataPath().getChildFile (name),
+            "*.json",
+            true);
+
+        fileChooser->launchAsync (
+            juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+            [] (const juce::FileChooser& fc) {
+                auto file = fc.getResult();
+                if (file == juce::File())
+                    return;
+
+                TraceRecorder::writeChromeJson (file.withFileExtension (".json"));
+            });
+    }
+
+    /** Plays outgoing MIDI on the built-in synth through the audio device, or stops. */
+    void toggleMonitoring()
+    {
+        auto& controller = owner.controller;
+        auto& engine = controller.getEngine();
+        engine.setMonitoring (! engine.isMonitoring());
+        controller.getSettings().set (Settings::localMonitor, engine.isMonitoring());
+    }
+
+    /** Monitors on the samples folder instead of the synth, or back. Rescans the folder each time. */
+    void toggleSamples()
+    {
+        auto& controller = owner.controller;
+        auto& engine = controller.getEngine();
+        const bool useSamples = engine.getInstrument() != Engine::samplePlayer;
+        if (useSamples)
+            engine.getSamplePlayer().loadFolder (Controller::getSamplesPath());
+        engine.setInstrument (useSamples ? Engine::samplePlayer : Engine::previewSynth);
+        controller.getSettings().set (Settings::monitorSamples, useSamples);
+    }
+
+    /** Closes the audio device to save power, or opens it again, and remembers the choice. */
+    void toggleMidiOnly()
+    {
+        auto& controller = owner.controller;
+        controller.setMidiOnly (! controller.isMidiOnly());
+        controller.getSettings().set (Settings::midiOnly, controller.isMidiOnly());
+    }
+
+    /** Starts or stops logging message thread stalls, and remembers the choice. */
+    void toggleStallWatchdog()
+    {
+        auto& controller = owner.controller;
+        auto& watchdog = controller.getStallWatchdog();
+        auto& settings = controller.getSettings();
+
+        if (watchdog.isRunning()) {
+            watchdog.stop();
+        } else {
+            const int threshold = settings.getInt (Settings::stallThreshold, StallWatchdog::defaultThreshold);
+            watchdog.start (threshold, StallWatchdog::getDefaultLogFile());
+        }
+        settings.set (Settings::stallWatchdog, watchdog.isRunning());
+    }
+
+    void showLibrarian()
+    {
+        if (! librarianWindow) {
+            librarianWindow.reset (new detail::ToolWindow ("SysEx Librarian", new LibrarianComponent (owner.controller)));
+            librarianWindow->centreAroundComponent (this, librarianWindow->getWidth(), librarianWindow->getHeight());
+        }
+
+        librarianWindow->setVisible (true);
+        librarianWindow->toFront (true);
+    }
+
+    void showStressGenerator()
+    {
+        if (! stressWindow) {
+            stressWindow.reset (new detail::ToolWindow ("Stress Generator", new StressGeneratorComponent (owner.controller)));
+            stressWindow->centreAroundComponent (this, stressWindow->getWidth(), stressWindow->getHeight());
+        }
+
+        stressWindow->setVisible (true);
+        stressWindow->toFront (true);
+    }
+
+    void showPlugins()
+    {
+        if (! pluginsWindow) {
+            pluginsWindow.reset (new detail::ToolWindow ("MIDI Plugins", new PluginChainComponent (owner.controller)));
+            pluginsWindow->centreAroundComponent (this, pluginsWindow->getWidth(), pluginsWindow->getHeight());
+        }
+
+        pluginsWindow->setVisible (true);
+        pluginsWindow->toFront (true);
+    }
+
+    void showLatencyTracer()
+    {
+        if (! latencyWindow) {
+            latencyWindow.reset (new detail::ToolWindow ("Latency Tracer", new LatencyTracerComponent (owner.controller)));
+            latencyWindow->centreAroundComponent (this, latencyWindow->getWidth(), latencyWindow->getHeight());
+        }
+
+        latencyWindow->setVisible (true);
+        latencyWindow->toFront (true);
+    }
+
     void showOrHideAboutDialog()
     {
         struct AboutContent : public juce::Component {
@@ -453,14 +732,17 @@ private:
     juce::TextButton ccEditorButton;
     juce::TextButton saveButton;
     juce::TextButton loadButton;
+    juce::TextButton toolsButton;
     juce::TextButton aboutButton;
     std::unique_ptr<juce::DocumentWindow> aboutWindow;
+    std::unique_ptr<juce::DocumentWindow> librarianWindow;
+    std::unique_ptr<juce::DocumentWindow> latencyWindow;
+    std::unique_ptr<juce::DocumentWindow> stressWindow;
+    std::unique_ptr<juce::DocumentWindow> pluginsWindow;
     std::unique_ptr<juce::FileChooser> fileChooser;
     Device device;
     juce::Value midiChannelValue;
     juce::Value midiProgramValue;
-    std::vector<juce::Value> dialValues;
-    std::vector<juce::Value> faderValues;
 
     juce::OwnedArray<CCDial> _dials;
     juce::Array<juce::MidiDeviceInfo> _devices;
@@ -469,6 +751,10 @@ private:
     std::vector<float> brushAlphas;         // Store horizontal brush pattern
     std::vector<float> verticalBrushAlphas; // Store vertical brush pattern
     juce::Image logo;
+    juce::Image background;
+    float backgroundScale = 1.0f;
+    PaintStats paintStats;
+    ControlRefresher refresher { *this };
 };
 
 MainComponent::MainComponent (Controller& vc)
@@ -490,14 +776,22 @@ MainComponent::MainComponent (Controller& vc)
         setSize (VMC_WIDTH, totalHeight);
     };
 
+    profiler.add ("Content", content->paintStats);
+    for (auto* dial : content->_dials)
+        profiler.add (dial->getName(), dial->getPaintStats());
+    profiler.add ("Keyboard", content->keyboard.getMidiKeyboardComponent().getPaintStats());
+    profiler.add ("CC Drawer", ccDrawer->getPaintStats());
+    profiler.add ("CC Editor", ccDrawer->getEditor().getPaintStats());
+
     // Set initial size to the base UI dimensions
     setSize (VMC_WIDTH, VMC_HEIGHT);
 
-    Timer::callAfterDelay (50, [this]() {
-        content->updateMidiOutputs();
-        content->updateWithSettings();
-        content->setDevice (controller.device());
-    });
+    // The window shows straight away, the output list fills in once the
+    // controller has opened the devices in the background.
+    content->setDevice (controller.device());
+    content->updateWithSettings();
+    if (controller.areDevicesReady())
+        content->devicesReady();
 }
 
 MainComponent::~MainComponent()
@@ -517,6 +811,7 @@ MainComponent::~MainComponent()
         props->setValue (Settings::currentDrawer, ccDrawer->isOpen() ? "ccEditor" : "");
     }
 
+    profilerOverlay.reset();
     ccDrawer.reset();
     content.reset();
 }
@@ -543,6 +838,54 @@ void MainComponent::resized()
             ccDrawer->setBounds (bounds.getX(), contentBounds.getBottom(), bounds.getWidth(), 0);
         }
     }
+
+    if (profilerOverlay != nullptr) {
+        const auto ideal = profilerOverlay->getIdealBounds();
+        profilerOverlay->setBounds (getWidth() - ideal.getWidth() - 8, 32, ideal.getWidth(), ideal.getHeight());
+    }
+}
+
+void MainComponent::setPaintProfilerVisible (bool shouldBeVisible)
+{
+    if (shouldBeVisible == isPaintProfilerVisible())
+        return;
+
+    if (! shouldBeVisible) {
+        profilerOverlay.reset();
+        return;
+    }
+
+    profiler.reset();
+    profilerOverlay = std::make_unique<PaintProfilerOverlay> (profiler);
+    profilerOverlay->getExtraLines = [this]() {
+        auto& keyboard = content->keyboard.getMidiKeyboardComponent();
+        return juce::StringArray (
+            String ("keyboard sprites: ") + (keyboard.isUsingSprites() ? "on" : "off"),
+            String ("controls: ") + String (content->refresher.getNumChanges()) + " changes, "
+                + String (content->refresher.getNumRefreshes()) + " refreshes");
+    };
+    addAndMakeVisible (profilerOverlay.get());
+    resized();
+}
+
+void MainComponent::exportPaintProfile()
+{
+    profileChooser = std::make_unique<juce::FileChooser> (
+        "Export Paint Profile",
+        Controller::getUserDataPath().getChildFile ("paint-profile.csv"),
+        "*.csv",
+        true);
+
+    const auto csv = profiler.toCsv();
+    profileChooser->launchAsync (
+        juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting,
+        [csv] (const juce::FileChooser& fc) {
+            auto file = fc.getResult();
+            if (file == juce::File())
+                return;
+
+            file.withFileExtension (".csv").replaceWithText (csv);
+        });
 }
 
 Device MainComponent::device() const
@@ -572,9 +915,11 @@ void MainComponent::toggleDrawer()
                 // a cleaner way to access these components
 
                 // Add dials (we know there are 8 from the code)
+                juce::Array<MidiCCMapping> mappings;
                 for (auto* dial : content->_dials) {
-                    editor.addMapping (dial->getName(), dial, MidiCCMapping::Dial);
+                    mappings.add (MidiCCEditor::createMapping (dial->getName(), dial, MidiCCMapping::Dial));
                 }
+                editor.addMappings (mappings);
             }
         }
     }
@@ -8,6 +8,7 @@
 
 #include "device.hpp"
 #include "midicceditor.hpp"
+#include "paintprofiler.hpp"
 
 // Base UI dimensions - the keyboard area should stay this size
 #ifndef VMC_WIDTH
@@ -39,9 +40,13 @@ public:
         _channel = juce::jlimit (1, 16, ch);
     }
 
+    void paint (juce::Graphics& g) override;
+    PaintStats& getPaintStats() noexcept { return _paintStats; }
+
 private:
     Controller& _controller;
     int _cc = 0, _channel = 1;
+    PaintStats _paintStats;
 };
 
 class MainComponent : public Component {
@@ -57,12 +62,23 @@ public:
     void paint (Graphics&) override;
     void resized() override;
 
+    /** Shows paint timings of the main components on top of the UI. */
+    void setPaintProfilerVisible (bool shouldBeVisible);
+    bool isPaintProfilerVisible() const noexcept { return profilerOverlay != nullptr; }
+    /** Asks for a file and writes the paint timings to it as CSV. */
+    void exportPaintProfile();
+    /** Returns the paint timings of the main components. */
+    PaintProfiler& getPaintProfiler() noexcept { return profiler; }
+
 private:
     Controller& controller;
     friend class Content;
     class Content;
     std::unique_ptr<Content> content;
     std::unique_ptr<MidiCCDrawer> ccDrawer;
+    PaintProfiler profiler;
+    std::unique_ptr<PaintProfilerOverlay> profilerOverlay;
+    std::unique_ptr<juce::FileChooser> profileChooser;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -4,6 +4,7 @@
 #include "maincomponent.hpp"
 #include "midicceditor.hpp"
 #include "controller.hpp"
+#include "tracing.hpp"
 
 namespace vmc {
 
@@ -131,11 +132,48 @@ MidiCCEditor::MidiCCEditor (Controller& ctrl) : controller (ctrl)
     addAndMakeVisible (table);
     table.setModel (this);
     setupTable();
+
+    addAndMakeVisible (searchBox);
+    searchBox.setTextToShowWhenEmpty ("Search", juce::Colours::white.withAlpha (0.4f));
+    searchBox.setColour (juce::TextEditor::backgroundColourId, juce::Colour::fromRGB (35, 38, 42));
+    searchBox.setColour (juce::TextEditor::textColourId, juce::Colours::white.withAlpha (0.9f));
+    searchBox.setColour (juce::TextEditor::outlineColourId, juce::Colours::white.withAlpha (0.2f));
+    searchBox.setColour (juce::TextEditor::focusedOutlineColourId, juce::Colours::white.withAlpha (0.4f));
+    searchBox.setFont (juce::Font (juce::FontOptions (12.0f)));
+    searchBox.onTextChange = [this]() { setFilter (searchBox.getText()); };
+    searchBox.onEscapeKey = [this]() {
+        searchBox.clear();
+        setFilter ({});
+    };
 }
 
-MidiCCEditor::~MidiCCEditor() = default;
+MidiCCEditor::~MidiCCEditor()
+{
+    cancelPendingUpdate();
+}
 
 void MidiCCEditor::paint (juce::Graphics& g)
+{
+    VMC_TRACE_SCOPE ("MidiCCEditor::paint");
+    ScopedPaintTimer timer (paintStats);
+
+    // The background only depends on size, render it once and blit it.
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int width = juce::jmax (1, juce::roundToInt ((float) getWidth() * scale));
+    const int height = juce::jmax (1, juce::roundToInt ((float) getHeight() * scale));
+
+    if (background.getWidth() != width || background.getHeight() != height) {
+        background = juce::Image (juce::Image::RGB, width, height, false);
+        juce::Graphics bg (background);
+        bg.addTransform (juce::AffineTransform::scale (scale));
+        paintBackground (bg);
+    }
+
+    g.drawImageTransformed (background, juce::AffineTransform::scale ((float) getWidth() / (float) width,
+                                                                      (float) getHeight() / (float) height));
+}
+
+void MidiCCEditor::paintBackground (juce::Graphics& g)
 {
     auto bounds = getLocalBounds();
 
@@ -178,8 +216,11 @@ void MidiCCEditor::paint (juce::Graphics& g)
 
 void MidiCCEditor::resized()
 {
+    background = {};
+
     auto bounds = getLocalBounds();
-    bounds.removeFromTop (25); // Space for header
+    auto header = bounds.removeFromTop (25); // Space for header
+    searchBox.setBounds (header.removeFromRight (160).reduced (3));
     table.setBounds (bounds);
 }
 
@@ -204,12 +245,14 @@ void MidiCCEditor::setupTable()
 
 void MidiCCEditor::refreshMappings()
 {
+    cancelPendingUpdate();
     mappings.clear();
+    visibleRows.clear();
     // This will be called from MainComponent to populate the mappings
     table.updateContent();
 }
 
-void MidiCCEditor::addMapping (const juce::String& name, juce::Component* comp, MidiCCMapping::ComponentType type)
+MidiCCMapping MidiCCEditor::createMapping (const juce::String& name, juce::Component* comp, MidiCCMapping::ComponentType type)
 {
     MidiCCMapping mapping;
     mapping.componentName = comp != nullptr ? comp->getName() : name;
@@ -218,17 +261,73 @@ void MidiCCEditor::addMapping (const juce::String& name, juce::Component* comp,
     mapping.midiChannel = 1;
     mapping.ccNumber = 0;
 
-    if (auto* d = dynamic_cast<CCDial*> (comp)) {
-        mapping.ccNumber = d->controllerNumber();
+    if (auto* dial = dynamic_cast<CCDial*> (comp))
+        mapping.ccNumber = dial->controllerNumber();
+
+    return mapping;
+}
+
+void MidiCCEditor::addMapping (const juce::String& name, juce::Component* comp, MidiCCMapping::ComponentType type)
+{
+    mappings.add (createMapping (name, comp, type));
+    if (matchesFilter (mappings.getReference (mappings.size() - 1)))
+        visibleRows.add (mappings.size() - 1);
+    triggerAsyncUpdate();
+}
+
+void MidiCCEditor::addMappings (const juce::Array<MidiCCMapping>& newMappings)
+{
+    mappings.ensureStorageAllocated (mappings.size() + newMappings.size());
+    visibleRows.ensureStorageAllocated (mappings.size());
+
+    for (const auto& mapping : newMappings) {
+        mappings.add (mapping);
+        if (matchesFilter (mapping))
+            visibleRows.add (mappings.size() - 1);
     }
 
-    mappings.add (mapping);
+    cancelPendingUpdate();
+    table.updateContent();
+}
+
+void MidiCCEditor::handleAsyncUpdate()
+{
     table.updateContent();
 }
 
+bool MidiCCEditor::matchesFilter (const MidiCCMapping& mapping) const
+{
+    return filterText.isEmpty()
+           || mapping.componentName.containsIgnoreCase (filterText)
+           || juce::String (mapping.ccNumber).startsWith (filterText);
+}
+
+void MidiCCEditor::setFilter (const juce::String& text)
+{
+    const auto newFilter = text.trim();
+    if (newFilter == filterText)
+        return;
+
+    // Typing more only narrows the matches, so only the visible rows need checking.
+    const bool narrowing = newFilter.startsWithIgnoreCase (filterText);
+    filterText = newFilter;
+
+    if (narrowing) {
+        visibleRows.removeIf ([this] (int index) { return ! matchesFilter (mappings.getReference (index)); });
+    } else {
+        visibleRows.clearQuick();
+        for (int i = 0; i < mappings.size(); ++i)
+            if (matchesFilter (mappings.getReference (i)))
+                visibleRows.add (i);
+    }
+
+    table.updateContent();
+    table.repaint();
+}
+
 int MidiCCEditor::getNumRows()
 {
-    return mappings.size();
+    return visibleRows.size();
 }
 
 void MidiCCEditor::paintRowBackground (juce::Graphics& g, int rowNumber, int width, int height, bool rowIsSelected)
@@ -254,7 +353,7 @@ void MidiCCEditor::paintRowBackground (juce::Graphics& g, int rowNumber, int wid
 
 void MidiCCEditor::paintCell (juce::Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected)
 {
-    if (rowNumber >= mappings.size())
+    if (rowNumber >= visibleRows.size())
         return;
 
     // Since both columns now use custom components, we don't need to paint any text
@@ -263,28 +362,35 @@ void MidiCCEditor::paintCell (juce::Graphics& g, int rowNumber, int columnId, in
 
 juce::Component* MidiCCEditor::refreshComponentForCell (int rowNumber, int columnId, bool isRowSelected, juce::Component* existingComponentToUpdate)
 {
-    if (rowNumber >= mappings.size())
+    if (! juce::isPositiveAndBelow (rowNumber, visibleRows.size()))
         return nullptr;
 
-    auto& mapping = mappings.getReference (rowNumber);
+    const int index = visibleRows.getUnchecked (rowNumber);
+    const auto& mapping = mappings.getReference (index);
 
+    // Each column only ever gets back the component type it created, and a
+    // cell's callback is set once and follows the row it is showing.
     if (columnId == ControlNameColumn) {
-        auto* nameEditor = dynamic_cast<ControlNameEditor*> (existingComponentToUpdate);
-        if (nameEditor == nullptr)
+        auto* nameEditor = static_cast<ControlNameEditor*> (existingComponentToUpdate);
+        if (nameEditor == nullptr) {
             nameEditor = new ControlNameEditor();
+            nameEditor->onTextChanged = [this, nameEditor] (const juce::String& newName) {
+                setControlName (nameEditor->getRow(), newName);
+            };
+        }
 
+        nameEditor->setRow (index);
         nameEditor->setText (mapping.componentName);
-        nameEditor->onTextChanged = [this, rowNumber] (const juce::String& newName) {
-            setControlName (rowNumber, newName);
-        };
         return nameEditor;
     } else if (columnId == CCNumberColumn) {
-        auto* editor = dynamic_cast<CCNumberEditor*> (existingComponentToUpdate);
-        if (editor == nullptr)
+        auto* editor = static_cast<CCNumberEditor*> (existingComponentToUpdate);
+        if (editor == nullptr) {
             editor = new CCNumberEditor();
+            editor->onValueChanged = [this, editor] (int value) { setCCMapping (editor->getRow(), value); };
+        }
 
+        editor->setRow (index);
         editor->setValue (mapping.ccNumber >= 0 ? mapping.ccNumber : 0);
-        editor->onValueChanged = [this, rowNumber] (int value) { setCCMapping (rowNumber, value); };
         return editor;
     }
 
@@ -296,8 +402,8 @@ void MidiCCEditor::setCCMapping (int row, int ccNumber)
     if (row >= 0 && row < mappings.size()) {
         auto& ref = mappings.getReference (row);
         ref.ccNumber = ccNumber;
-        if (auto* d = dynamic_cast<CCDial*> (ref.component))
-            d->setControllerNumber (ccNumber);
+        if (auto* dial = dynamic_cast<CCDial*> (ref.component))
+            dial->setControllerNumber (ccNumber);
     }
 }
 
@@ -340,6 +446,9 @@ MidiCCDrawer::~MidiCCDrawer()
 
 void MidiCCDrawer::paint (juce::Graphics& g)
 {
+    VMC_TRACE_SCOPE ("MidiCCDrawer::paint");
+    ScopedPaintTimer timer (paintStats);
+
     if (currentDrawerHeight > 0) {
         auto bounds = getLocalBounds();
 
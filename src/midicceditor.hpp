@@ -6,6 +6,8 @@
 #include "juce.hpp"
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include "paintstats.hpp"
+
 namespace vmc {
 
 class Controller;
@@ -22,12 +24,17 @@ public:
 
     std::function<void (int)> onValueChanged;
 
+    /** The mapping this cell currently shows, cells are reused as the table scrolls. */
+    void setRow (int newRow) noexcept { row = newRow; }
+    int getRow() const noexcept { return row; }
+
     void resized() override;
     void focusLost (juce::Component::FocusChangeType cause) override;
 
 private:
     juce::TextEditor textEditor;
     int currentValue = 0;
+    int row = -1;
 
     void validateAndUpdate();
 
@@ -46,6 +53,10 @@ public:
 
     std::function<void (const juce::String&)> onTextChanged;
 
+    /** The mapping this cell currently shows, cells are reused as the table scrolls. */
+    void setRow (int newRow) noexcept { row = newRow; }
+    int getRow() const noexcept { return row; }
+
     void resized() override;
 
     // Label::Listener override
@@ -53,6 +64,7 @@ public:
 
 private:
     juce::Label nameLabel;
+    int row = -1;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlNameEditor)
 };
@@ -77,8 +89,13 @@ struct MidiCCMapping {
 };
 
 // Main MIDI CC Editor table component
+//
+// Only visible rows have cell components, the table recycles them while
+// scrolling and each cell is wired up once when created. Rows can be
+// filtered by name or CC number from the search box.
 class MidiCCEditor : public juce::Component,
-                     public juce::TableListBoxModel {
+                     public juce::TableListBoxModel,
+                     private juce::AsyncUpdater {
 public:
     MidiCCEditor (Controller& controller);
     ~MidiCCEditor() override;
@@ -96,9 +113,18 @@ public:
     // Table setup
     void setupTable();
     void refreshMappings();
+    /** Adds a mapping, the table updates once for a run of adds. */
     void addMapping (const juce::String& name, juce::Component* comp, MidiCCMapping::ComponentType type);
+    /** Adds many mappings with a single table update. */
+    void addMappings (const juce::Array<MidiCCMapping>& newMappings);
+    /** Creates a mapping for a component, reading its CC number if it has one. */
+    static MidiCCMapping createMapping (const juce::String& name, juce::Component* comp, MidiCCMapping::ComponentType type);
 
-    // MIDI CC functionality
+    /** Shows only mappings whose name contains the text or whose CC number starts with it. */
+    void setFilter (const juce::String& text);
+    juce::String getFilter() const { return filterText; }
+
+    // MIDI CC functionality, rows are mapping indexes regardless of filtering
     void setCCMapping (int row, int ccNumber);
     void setControlName (int row, const juce::String& name);
 
@@ -107,13 +133,24 @@ public:
     bool isDrawerOpen() const { return drawerOpen; }
     void toggleDrawer();
 
+    PaintStats& getPaintStats() noexcept { return paintStats; }
+
 private:
     Controller& controller;
     juce::TableListBox table;
+    juce::TextEditor searchBox;
     juce::Array<MidiCCMapping> mappings;
+    juce::Array<int> visibleRows; // mapping indexes that pass the filter
+    juce::String filterText;
+    juce::Image background;
+    PaintStats paintStats;
 
     bool drawerOpen = false;
 
+    void paintBackground (juce::Graphics& g);
+    bool matchesFilter (const MidiCCMapping& mapping) const;
+    void handleAsyncUpdate() override;
+
     // Column IDs
     enum ColumnIds {
         ControlNameColumn = 1,
@@ -139,6 +176,7 @@ public:
     int getDrawerHeight() const { return targetDrawerHeight; }
 
     MidiCCEditor& getEditor() { return editor; }
+    PaintStats& getPaintStats() noexcept { return paintStats; }
 
     // Callback for when drawer size changes
     std::function<void (int newHeight)> onSizeChanged;
@@ -146,6 +184,7 @@ public:
 private:
     Controller& controller;
     MidiCCEditor editor;
+    PaintStats paintStats;
 
     bool isDrawerOpen = false;
     int currentDrawerHeight = 0;
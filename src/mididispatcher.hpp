@@ -0,0 +1,101 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include "device.hpp"
+#include "latencytracer.hpp"
+#include "tracing.hpp"
+
+namespace vmc {
+
+/** Listens to Device ValueTree data and generates MIDI messages when values change. */
+class MidiDispatcher : public juce::ValueTree::Listener {
+public:
+    /** Callback function type for receiving generated MIDI messages. */
+    using MidiCallback = std::function<void (const MidiMessage&)>;
+
+    MidiDispatcher() = default;
+    ~MidiDispatcher() override { detach(); }
+
+    /** Attaches the dispatcher to a Device's data and starts listening for changes.
+        @param device The device to monitor for changes.
+        @param callback The callback function to invoke when MIDI messages are generated.
+    */
+    void attach (Device& device, MidiCallback callback)
+    {
+        detach();
+        _data = device.data();
+        _midiCallback = std::move (callback);
+        _data.addListener (this);
+    }
+
+    /** Detaches from the current device and stops listening. */
+    void detach()
+    {
+        if (_data.isValid())
+            _data.removeListener (this);
+        _data = juce::ValueTree();
+        _midiCallback = nullptr;
+    }
+
+    /** Returns true if currently attached to a device. */
+    bool isAttached() const noexcept { return _data.isValid() && _midiCallback != nullptr; }
+
+    /** Stops generating messages while muted, the model keeps updating. */
+    void setMuted (bool shouldBeMuted) noexcept { _muted = shouldBeMuted; }
+
+private:
+    juce::ValueTree _data;
+    MidiCallback _midiCallback;
+    bool _muted = false;
+
+    void sendMidiMessage (const MidiMessage& msg)
+    {
+        if (_midiCallback)
+            _midiCallback (msg);
+    }
+
+    int getMidiChannel() const noexcept
+    {
+        return _data.getProperty (Device::midiChannelID, 1);
+    }
+
+    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override
+    {
+        if (! _midiCallback || _muted)
+            return;
+        VMC_TRACE_SCOPE ("MidiDispatcher::valueTreePropertyChanged");
+        LatencyTracer::mark (LatencyTracer::dispatch);
+
+        // Handle device-level property changes
+        if (tree == _data) {
+            if (property == Device::midiProgramID) {
+                int program = static_cast<int> (tree.getProperty (property)) - 1; // MIDI programs are 0-127
+                program = juce::jlimit (0, 127, program);
+                sendMidiMessage (MidiMessage::programChange (getMidiChannel(), program));
+            }
+            return;
+        }
+
+        // Handle dial/fader value changes (Ranged children)
+        if (tree.getType() == Device::RangedID && property == Device::valueID) {
+            auto parent = tree.getParent();
+            if (parent.isValid() && (parent.getType() == Device::dialsID || parent.getType() == Device::fadersID)) {
+                int ccNumber = tree.getProperty (Device::ccNumberID, 0);
+                int value = static_cast<int> (tree.getProperty (Device::valueID));
+                value = juce::jlimit (0, 127, value);
+                sendMidiMessage (MidiMessage::controllerEvent (getMidiChannel(), ccNumber, value));
+            }
+        }
+    }
+
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override {}
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override {}
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override {}
+    void valueTreeParentChanged (juce::ValueTree&) override {}
+    void valueTreeRedirected (juce::ValueTree&) override {}
+};
+
+} // namespace vmc
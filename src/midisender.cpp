@@ -0,0 +1,221 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "midisender.hpp"
+#include "sharedmidiring.hpp"
+#include "tracing.hpp"
+
+namespace vmc {
+
+MidiSender::MidiSender (SendFunction fn, int capacity, int interval)
+    : juce::Thread ("VMC MIDI Sender"),
+      sendFunction (std::move (fn)),
+      pollInterval (interval),
+      fifo (capacity),
+      slots ((size_t) capacity)
+{
+}
+
+MidiSender::~MidiSender()
+{
+    stop();
+}
+
+void MidiSender::start()
+{
+    startThread (juce::Thread::Priority::high);
+}
+
+void MidiSender::stop()
+{
+    signalThreadShouldExit();
+    wake();
+    stopThread (1000);
+}
+
+void MidiSender::setSharedRing (SharedMidiRing* newRing)
+{
+    const bool wasRunning = isThreadRunning();
+    if (wasRunning)
+        stop();
+    {
+        // Waits out any producer inside wake() with the old ring.
+        const juce::SpinLock::ScopedLockType sl (ringLock);
+        ring.store (newRing);
+    }
+    if (wasRunning)
+        start();
+}
+
+void MidiSender::wake()
+{
+    const juce::SpinLock::ScopedLockType sl (ringLock);
+    if (auto* r = ring.load())
+        r->wakeReader();
+    else
+        notify();
+}
+
+bool MidiSender::add (const juce::MidiMessage& message)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl (writeLock);
+        const auto scope = fifo.write (1);
+        if (scope.blockSize1 + scope.blockSize2 < 1) {
+            ++numDropped;
+            return false;
+        }
+
+        auto& slot = slots[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        slot.message = message;
+        slot.enqueued = juce::Time::getMillisecondCounterHiRes();
+        setTrace (slot);
+    }
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        ++numFromMessageThread;
+    if (pollInterval <= 0)
+        wake();
+    return true;
+}
+
+bool MidiSender::add (const juce::MidiBuffer& buffer)
+{
+    const int numEvents = buffer.getNumEvents();
+    if (numEvents == 0)
+        return true;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (writeLock);
+        if (fifo.getFreeSpace() < numEvents) {
+            numDropped += numEvents;
+            return false;
+        }
+
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        const auto scope = fifo.write (numEvents);
+        int index = 0;
+        for (const auto metadata : buffer) {
+            const int slot = index < scope.blockSize1 ? scope.startIndex1 + index
+                                                      : scope.startIndex2 + (index - scope.blockSize1);
+            slots[(size_t) slot].message = metadata.getMessage();
+            slots[(size_t) slot].enqueued = now;
+            setTrace (slots[(size_t) slot]);
+            ++index;
+        }
+    }
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        numFromMessageThread += numEvents;
+    if (pollInterval <= 0)
+        wake();
+    return true;
+}
+
+void MidiSender::setTrace (Slot& slot) noexcept
+{
+    if (auto* trace = LatencyTracer::getCurrentTrace()) {
+        slot.trace = *trace;
+        slot.trace.times[LatencyTracer::enqueue] = slot.enqueued;
+    } else {
+        slot.trace.tracer = nullptr;
+    }
+}
+
+double MidiSender::getAverageLatency() const noexcept
+{
+    const auto count = numSent.load();
+    return count > 0 ? (double) totalLatencyNanos.load() * 1.0e-6 / (double) count : 0.0;
+}
+
+void MidiSender::send (const juce::MidiMessage& message)
+{
+    const auto before = juce::Time::getHighResolutionTicks();
+    sendFunction (message);
+    const auto ticks = juce::Time::getHighResolutionTicks() - before;
+    sendCall.record ((juce::int64) (juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6));
+}
+
+bool MidiSender::drain()
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady <= 0)
+        return false;
+
+    VMC_TRACE_SCOPE ("MidiSender::drain");
+    const auto scope = fifo.read (numReady);
+    scope.forEach ([this] (int index) {
+        auto& slot = slots[(size_t) index];
+        send (slot.message);
+
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        const auto nanos = (juce::int64) ((now - slot.enqueued) * 1.0e6);
+        totalLatencyNanos += nanos;
+        if (nanos > maxLatencyNanos.load (std::memory_order_relaxed))
+            maxLatencyNanos.store (nanos, std::memory_order_relaxed);
+        ++numSent;
+
+        if (auto* tracer = slot.trace.tracer) {
+            slot.trace.times[LatencyTracer::send] = now;
+            tracer->record (slot.trace);
+        }
+    });
+
+    return true;
+}
+
+bool MidiSender::drainRing (SharedMidiRing& shared, juce::uint64& nextDue)
+{
+    bool sentAny = false;
+    const auto now = SharedMidiRing::now();
+
+    nextDue = shared.read ([this, &sentAny, now] (const juce::uint8* data, int size, juce::uint64 timestamp) {
+        send (juce::MidiMessage (data, size));
+        sentAny = true;
+        ++numInjected;
+
+        if (timestamp > 0) {
+            const auto lateness = (juce::int64) (SharedMidiRing::now() - timestamp);
+            if (lateness > maxLatenessNanos.load (std::memory_order_relaxed))
+                maxLatenessNanos.store (lateness, std::memory_order_relaxed);
+        }
+    },
+                           now);
+
+    return sentAny;
+}
+
+void MidiSender::run()
+{
+    auto* const shared = ring.load();
+
+    while (! threadShouldExit()) {
+        bool busy = drain();
+
+        if (shared == nullptr) {
+            if (! busy)
+                wait (pollInterval > 0 ? pollInterval : -1);
+            continue;
+        }
+
+        juce::uint64 nextDue = 0;
+        busy = drainRing (*shared, nextDue) || busy;
+        if (busy)
+            continue;
+
+        // Sleep until the next timestamped event is due, a writer wakes us, or
+        // a message is added in this process.
+        juce::uint64 timeoutMicros = 100000;
+        if (nextDue > 0) {
+            const auto now = SharedMidiRing::now();
+            timeoutMicros = nextDue > now ? juce::jmin (timeoutMicros, (nextDue - now) / 1000) : 0;
+        }
+        if (timeoutMicros > 0)
+            shared->waitForData ((int) timeoutMicros, [this] { return fifo.getNumReady() > 0 || threadShouldExit(); });
+    }
+
+    while (drain()) {
+    }
+}
+
+} // namespace vmc
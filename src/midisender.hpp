@@ -0,0 +1,97 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+
+class SharedMidiRing;
+
+/** Queues outgoing MIDI and sends it from a dedicated thread.
+
+    Any thread may add messages. Producers take a short spin lock to reserve
+    space in the queue, the sender thread reads it without locking. The thread
+    can also drain a SharedMidiRing written by another process.
+*/
+class MidiSender final : private juce::Thread {
+public:
+    using SendFunction = std::function<void (const juce::MidiMessage&)>;
+
+    /** With a poll interval in milliseconds the thread checks the queue that
+        often and adding never wakes it, so a producer like the audio thread
+        doesn't touch the scheduler. Zero sleeps until woken.
+    */
+    explicit MidiSender (SendFunction sendFunction, int capacity = 8192, int pollInterval = 0);
+    ~MidiSender() override;
+
+    /** Starts the sender thread. */
+    void start();
+    /** Sends anything still queued and stops the sender thread. */
+    void stop();
+
+    /** Queues a message. Returns false if the queue is full. */
+    bool add (const juce::MidiMessage& message);
+
+    /** Queues all messages in a buffer back to back, or none if they don't fit. */
+    bool add (const juce::MidiBuffer& buffer);
+
+    /** Drains a shared memory ring as well as the queue, or stops draining it
+        when null. The thread is restarted if running. Once this returns no
+        producer can still be waking the old ring, so it may be deleted.
+    */
+    void setSharedRing (SharedMidiRing* ring);
+
+    /** Returns the number of messages waiting to be sent. */
+    int getNumPending() const noexcept { return fifo.getNumReady(); }
+    /** Returns the number of messages sent. */
+    juce::int64 getNumSent() const noexcept { return numSent.load(); }
+    /** Returns the number of messages queued from the message thread. */
+    juce::int64 getNumFromMessageThread() const noexcept { return numFromMessageThread.load(); }
+    /** Returns the number of messages dropped because the queue was full. */
+    juce::int64 getNumDropped() const noexcept { return numDropped.load(); }
+    /** Returns the average time in milliseconds messages spent in the queue. */
+    double getAverageLatency() const noexcept;
+    /** Returns the longest time in milliseconds a message spent in the queue. */
+    double getMaxLatency() const noexcept { return (double) maxLatencyNanos.load() * 1.0e-6; }
+    /** Returns the number of messages sent from the shared ring. */
+    juce::int64 getNumInjected() const noexcept { return numInjected.load(); }
+    /** Returns the most a timestamped ring message went out after its due time, in milliseconds. */
+    double getMaxLateness() const noexcept { return (double) maxLatenessNanos.load() * 1.0e-6; }
+    /** Returns how long each call to the send function took, in microseconds.
+        Reset it to measure a run.
+    */
+    LatencyHistogram& getSendCallTimes() noexcept { return sendCall; }
+
+private:
+    struct Slot {
+        juce::MidiMessage message;
+        double enqueued = 0.0;
+        LatencyTracer::Trace trace;
+    };
+
+    SendFunction sendFunction;
+    const int pollInterval;
+    juce::AbstractFifo fifo;
+    std::vector<Slot> slots;
+    juce::SpinLock writeLock;
+    std::atomic<juce::int64> numSent { 0 }, numDropped { 0 }, numFromMessageThread { 0 };
+    std::atomic<juce::int64> totalLatencyNanos { 0 }, maxLatencyNanos { 0 };
+    std::atomic<juce::int64> numInjected { 0 }, maxLatenessNanos { 0 };
+    LatencyHistogram sendCall;
+    std::atomic<SharedMidiRing*> ring { nullptr };
+    juce::SpinLock ringLock;
+
+    void wake();
+    void send (const juce::MidiMessage& message);
+    static void setTrace (Slot& slot) noexcept;
+    bool drain();
+    bool drainRing (SharedMidiRing&, juce::uint64& nextDue);
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (MidiSender)
+};
+
+} // namespace vmc
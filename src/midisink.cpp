@@ -0,0 +1,75 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "midisink.hpp"
+
+namespace vmc {
+
+MidiPortSink::MidiPortSink (juce::AudioDeviceManager& d, const juce::String& virtualOutputName)
+    : devices (d)
+{
+#if JUCE_MAC || JUCE_LINUX
+    virtualOutput = juce::MidiOutput::createNewDevice (virtualOutputName);
+    if (virtualOutput != nullptr)
+        virtualOutput->startBackgroundThread();
+#else
+    juce::ignoreUnused (virtualOutputName);
+#endif
+}
+
+MidiPortSink::~MidiPortSink()
+{
+    if (virtualOutput != nullptr)
+        virtualOutput->stopBackgroundThread();
+}
+
+void MidiPortSink::send (const juce::MidiMessage& message)
+{
+    if (virtualOutput != nullptr)
+        virtualOutput->sendMessageNow (message);
+    if (auto* const output = devices.getDefaultMidiOutput())
+        output->sendMessageNow (message);
+    ++numReceived;
+}
+
+//==============================================================================
+LoopbackMidiSink::LoopbackMidiSink (int capacity)
+    : events ((size_t) juce::jmax (1, capacity))
+{
+}
+
+void LoopbackMidiSink::send (const juce::MidiMessage& message)
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const int index = numRecorded.load (std::memory_order_relaxed);
+    if (index < (int) events.size()) {
+        auto& event = events[(size_t) index];
+        event.message = message;
+        event.received = now;
+        numRecorded.store (index + 1, std::memory_order_release);
+    }
+
+    ++numReceived;
+    received.signal();
+}
+
+bool LoopbackMidiSink::waitForMessages (juce::int64 count, int timeoutMs)
+{
+    const auto end = juce::Time::getMillisecondCounter() + (juce::uint32) juce::jmax (0, timeoutMs);
+    while (numReceived.load() < count) {
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now >= end)
+            return false;
+        received.wait ((double) (end - now));
+    }
+    return true;
+}
+
+void LoopbackMidiSink::clear()
+{
+    numRecorded = 0;
+    numReceived = 0;
+    received.reset();
+}
+
+} // namespace vmc
@@ -0,0 +1,94 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+/** Where outgoing MIDI ends up.
+
+    The controller's sender thread calls send() for every message, one at a
+    time. Implementations should not block for long.
+*/
+class MidiSink {
+public:
+    virtual ~MidiSink() = default;
+
+    /** Sends a message now. Called from the sender thread. */
+    virtual void send (const juce::MidiMessage& message) = 0;
+
+    /** Returns the number of messages sent. */
+    juce::int64 getNumReceived() const noexcept { return numReceived.load(); }
+
+protected:
+    std::atomic<juce::int64> numReceived { 0 };
+};
+
+/** Sends to the default MIDI output of a device manager, and to a virtual
+    output other apps can connect to where the platform supports it.
+*/
+class MidiPortSink final : public MidiSink {
+public:
+    MidiPortSink (juce::AudioDeviceManager& devices, const juce::String& virtualOutputName);
+    ~MidiPortSink() override;
+
+    void send (const juce::MidiMessage& message) override;
+
+private:
+    juce::AudioDeviceManager& devices;
+    std::unique_ptr<juce::MidiOutput> virtualOutput;
+    JUCE_DECLARE_NON_COPYABLE (MidiPortSink)
+};
+
+/** Drops everything, for measuring the cost of getting messages to the sink. */
+class NullMidiSink final : public MidiSink {
+public:
+    NullMidiSink() = default;
+    void send (const juce::MidiMessage&) override { ++numReceived; }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (NullMidiSink)
+};
+
+/** Records messages with the time they arrived, so the latency from a
+    timestamped gesture to the send can be measured without any ports.
+
+    Arrival times use the same clock as Time::getMillisecondCounterHiRes(), in
+    seconds, so they compare directly with message timestamps made from it.
+    Recording stops when the capacity is reached, the count keeps going.
+*/
+class LoopbackMidiSink final : public MidiSink {
+public:
+    struct Event {
+        juce::MidiMessage message;
+        double received = 0.0;
+
+        /** Returns the seconds from the message's timestamp to its arrival. */
+        double getLatency() const noexcept { return received - message.getTimeStamp(); }
+    };
+
+    explicit LoopbackMidiSink (int capacity = 65536);
+
+    void send (const juce::MidiMessage& message) override;
+
+    /** Returns the number of recorded events. */
+    int getNumEvents() const noexcept { return juce::jmin (numRecorded.load(), (int) events.size()); }
+    /** Returns a recorded event, index must be less than getNumEvents(). */
+    const Event& getEvent (int index) const noexcept { return events[(size_t) index]; }
+
+    /** Waits until at least a number of messages have arrived, returns false on timeout. */
+    bool waitForMessages (juce::int64 count, int timeoutMs);
+
+    /** Forgets recorded events. Only call while nothing is being sent. */
+    void clear();
+
+private:
+    std::vector<Event> events;
+    std::atomic<int> numRecorded { 0 };
+    juce::WaitableEvent received;
+    JUCE_DECLARE_NON_COPYABLE (LoopbackMidiSink)
+};
+
+} // namespace vmc
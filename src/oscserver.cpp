@@ -0,0 +1,273 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "oscserver.hpp"
+#include "device.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int defaultVelocity = 100;
+
+/** Converts an argument to a MIDI value, ints are 0-127 and floats 0-1. */
+static int toMidiValue (const juce::OSCArgument& arg) noexcept
+{
+    if (arg.isInt32())
+        return juce::jlimit (0, 127, (int) arg.getInt32());
+    if (arg.isFloat32())
+        return juce::jlimit (0, 127, juce::roundToInt (arg.getFloat32() * 127.0f));
+    return -1;
+}
+
+static int argumentAsMidiValue (const juce::OSCMessage& message, int index) noexcept
+{
+    return index < message.size() ? toMidiValue (message[index]) : -1;
+}
+} // namespace detail
+
+OscServer::OscServer (Controller& c)
+    : controller (c)
+{
+    for (int i = 0; i < maxControls; ++i) {
+        dialCCs[(size_t) i].store (0);
+        faderCCs[(size_t) i].store (0);
+        pendingDials[(size_t) i].store (-1);
+        pendingFaders[(size_t) i].store (-1);
+    }
+
+    controller.addListener (this);
+    deviceChanged();
+}
+
+OscServer::~OscServer()
+{
+    stop();
+    cancelPendingUpdate();
+    controller.removeListener (this);
+    if (data.isValid())
+        data.removeListener (this);
+}
+
+bool OscServer::start (int newPort)
+{
+    stop();
+    if (! receiver.connect (newPort))
+        return false;
+
+    port = newPort;
+    startTime = juce::Time::getMillisecondCounterHiRes();
+    receiver.addListener (this);
+    return true;
+}
+
+void OscServer::stop()
+{
+    if (port == 0)
+        return;
+    receiver.removeListener (this);
+    receiver.disconnect();
+    port = 0;
+}
+
+OscServer::Stats OscServer::getStats() const
+{
+    Stats stats;
+    stats.messages = numMessages.load();
+    stats.bundles = numBundles.load();
+    stats.errors = numErrors.load();
+
+    const auto elapsed = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+    stats.messagesPerSecond = elapsed > 0.0 ? (double) stats.messages / elapsed : 0.0;
+    stats.averageLatency = stats.messages > 0 ? (double) totalLatencyNanos.load() * 1.0e-6 / (double) stats.messages : 0.0;
+    stats.maxLatency = (double) maxLatencyNanos.load() * 1.0e-6;
+    return stats;
+}
+
+juce::String OscServer::getStatsText() const
+{
+    const auto stats = getStats();
+    juce::String text;
+    text << "osc port " << port << ": "
+         << stats.messages << " messages, "
+         << stats.bundles << " bundles, "
+         << stats.errors << " errors, "
+         << juce::String (stats.messagesPerSecond, 1) << " msg/s, latency avg "
+         << juce::String (stats.averageLatency, 3) << " ms max "
+         << juce::String (stats.maxLatency, 3) << " ms";
+    return text;
+}
+
+//==============================================================================
+void OscServer::oscMessageReceived (const juce::OSCMessage& message)
+{
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    const ScopedLatencyTrace trace (controller.getLatencyTracer(), start);
+    juce::MidiBuffer buffer;
+    if (addMessage (message, buffer))
+        controller.addMidiBuffer (buffer);
+    recordLatency (start, 1);
+}
+
+void OscServer::oscBundleReceived (const juce::OSCBundle& bundle)
+{
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    const ScopedLatencyTrace trace (controller.getLatencyTracer(), start);
+    juce::MidiBuffer buffer;
+    addBundle (bundle, buffer);
+
+    // Queue the whole bundle at once so it goes out as one burst.
+    controller.addMidiBuffer (buffer);
+    ++numBundles;
+    recordLatency (start, buffer.getNumEvents());
+}
+
+void OscServer::addBundle (const juce::OSCBundle& bundle, juce::MidiBuffer& buffer)
+{
+    for (const auto& element : bundle) {
+        if (element.isMessage())
+            addMessage (element.getMessage(), buffer);
+        else if (element.isBundle())
+            addBundle (element.getBundle(), buffer);
+    }
+}
+
+bool OscServer::addMessage (const juce::OSCMessage& message, juce::MidiBuffer& buffer)
+{
+    const auto address = juce::StringArray::fromTokens (message.getAddressPattern().toString(), "/", {});
+    // address[0] is empty, the pattern starts with a slash
+    if (address.size() < 3 || address[1] != "vmc") {
+        ++numErrors;
+        return false;
+    }
+
+    ++numMessages;
+    const auto& type = address[2];
+    const int ch = channel.load (std::memory_order_relaxed);
+    const int pos = 0; // events at the same position keep the order they were added
+
+    if (type == "dial" || type == "fader") {
+        const bool isDial = type == "dial";
+        const int index = address[3].getIntValue() - 1;
+        const int value = detail::argumentAsMidiValue (message, 0);
+        if (! juce::isPositiveAndBelow (index, (isDial ? numDials : numFaders).load()) || value < 0) {
+            ++numErrors;
+            return false;
+        }
+
+        const int cc = (isDial ? dialCCs : faderCCs)[(size_t) index].load (std::memory_order_relaxed);
+        buffer.addEvent (juce::MidiMessage::controllerEvent (ch, cc, value), pos);
+        (isDial ? pendingDials : pendingFaders)[(size_t) index].store (value, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+        return true;
+    }
+
+    if (type == "cc") {
+        const int number = detail::argumentAsMidiValue (message, 0);
+        const int value = detail::argumentAsMidiValue (message, 1);
+        if (number < 0 || value < 0) {
+            ++numErrors;
+            return false;
+        }
+        buffer.addEvent (juce::MidiMessage::controllerEvent (ch, number, value), pos);
+        return true;
+    }
+
+    if (type == "note" || type == "noteoff") {
+        // A note without a velocity plays at the default, a velocity that isn't a number is an error.
+        const int key = detail::argumentAsMidiValue (message, 0);
+        int velocity = 0;
+        if (type == "note")
+            velocity = message.size() > 1 ? detail::argumentAsMidiValue (message, 1) : detail::defaultVelocity;
+        if (key < 0 || velocity < 0) {
+            ++numErrors;
+            return false;
+        }
+        buffer.addEvent (velocity > 0 ? juce::MidiMessage::noteOn (ch, key, (juce::uint8) velocity)
+                                      : juce::MidiMessage::noteOff (ch, key),
+                         pos);
+        return true;
+    }
+
+    if (type == "program") {
+        const int program = message.size() > 0 && message[0].isInt32() ? (int) message[0].getInt32() : 0;
+        if (! juce::isPositiveAndNotGreaterThan (program, 128) || program == 0) {
+            ++numErrors;
+            return false;
+        }
+        buffer.addEvent (juce::MidiMessage::programChange (ch, program - 1), pos);
+        pendingProgram.store (program, std::memory_order_relaxed);
+        triggerAsyncUpdate();
+        return true;
+    }
+
+    ++numErrors;
+    return false;
+}
+
+void OscServer::recordLatency (double startMillis, int count)
+{
+    if (count <= 0)
+        return;
+
+    const auto nanos = (juce::int64) ((juce::Time::getMillisecondCounterHiRes() - startMillis) * 1.0e6);
+    totalLatencyNanos += nanos * count;
+    if (nanos > maxLatencyNanos.load (std::memory_order_relaxed))
+        maxLatencyNanos.store (nanos, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void OscServer::refreshMapping()
+{
+    const auto dials = data.getChildWithName (Device::dialsID);
+    const auto faders = data.getChildWithName (Device::fadersID);
+
+    for (int i = 0; i < juce::jmin (maxControls, dials.getNumChildren()); ++i)
+        dialCCs[(size_t) i].store (dials.getChild (i).getProperty (Device::ccNumberID, 0));
+    for (int i = 0; i < juce::jmin (maxControls, faders.getNumChildren()); ++i)
+        faderCCs[(size_t) i].store (faders.getChild (i).getProperty (Device::ccNumberID, 0));
+
+    numDials.store (juce::jmin (maxControls, dials.getNumChildren()));
+    numFaders.store (juce::jmin (maxControls, faders.getNumChildren()));
+    channel.store (juce::jlimit (1, 16, (int) data.getProperty (Device::midiChannelID, 1)));
+}
+
+void OscServer::deviceChanged()
+{
+    if (data.isValid())
+        data.removeListener (this);
+    data = controller.device().data();
+    data.addListener (this);
+    refreshMapping();
+}
+
+void OscServer::valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier& property)
+{
+    if (property == Device::ccNumberID || property == Device::midiChannelID)
+        refreshMapping();
+}
+
+void OscServer::handleAsyncUpdate()
+{
+    // The MIDI has been sent already, only bring the model up to date.
+    controller.updateDeviceWithoutMidi ([this] (Device& device) {
+        auto dials = device.dials();
+        for (int i = 0; i < juce::jmin (maxControls, dials.getNumChildren()); ++i) {
+            const int value = pendingDials[(size_t) i].exchange (-1, std::memory_order_relaxed);
+            if (value >= 0)
+                dials.getChild (i).setProperty (Device::valueID, value, nullptr);
+        }
+
+        auto faders = device.faders();
+        for (int i = 0; i < juce::jmin (maxControls, faders.getNumChildren()); ++i) {
+            const int value = pendingFaders[(size_t) i].exchange (-1, std::memory_order_relaxed);
+            if (value >= 0)
+                faders.getChild (i).setProperty (Device::valueID, value, nullptr);
+        }
+
+        const int program = pendingProgram.exchange (-1, std::memory_order_relaxed);
+        if (program > 0)
+            device.setMidiProgram (program);
+    });
+}
+
+} // namespace vmc
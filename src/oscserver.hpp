@@ -0,0 +1,91 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_osc/juce_osc.h>
+
+#include "controller.hpp"
+
+namespace vmc {
+
+/** Listens for OSC on a local UDP port and turns it into MIDI.
+
+    Messages are handled on the network thread and go straight to the MIDI
+    sender, the device model is updated afterwards on the message thread for
+    display only. Supported addresses:
+
+        /vmc/dial/<n> <value>      /vmc/fader/<n> <value>
+        /vmc/cc <number> <value>   /vmc/program <1-128>
+        /vmc/note <key> <velocity> /vmc/noteoff <key>
+
+    Integer values are MIDI values 0-127, floats are normalised 0-1. Indexes
+    are 1-based. A note without a velocity plays at 100, a velocity of 0 is
+    a note off. All messages in a bundle are queued together as one burst.
+*/
+class OscServer final : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>,
+                        private juce::ValueTree::Listener,
+                        private juce::AsyncUpdater,
+                        private Controller::Listener {
+public:
+    struct Stats {
+        juce::int64 messages = 0;
+        juce::int64 bundles = 0;
+        juce::int64 errors = 0;
+        double messagesPerSecond = 0.0;
+        double averageLatency = 0.0; // ms from receipt to queued
+        double maxLatency = 0.0;
+    };
+
+    explicit OscServer (Controller& controller);
+    ~OscServer() override;
+
+    /** Starts listening on the given port. */
+    bool start (int port);
+    /** Stops listening. */
+    void stop();
+
+    /** Returns the port being listened on, or 0. */
+    int getPort() const noexcept { return port; }
+
+    /** Returns counters and latency stats. */
+    Stats getStats() const;
+    /** Returns the stats as a single line of text. */
+    juce::String getStatsText() const;
+
+private:
+    static constexpr int maxControls = 128;
+
+    Controller& controller;
+    juce::OSCReceiver receiver { "VMC OSC" };
+    juce::ValueTree data;
+    int port = 0;
+
+    std::atomic<int> channel { 1 };
+    std::atomic<int> numDials { 0 }, numFaders { 0 };
+    std::array<std::atomic<int>, maxControls> dialCCs, faderCCs;
+    std::array<std::atomic<int>, maxControls> pendingDials, pendingFaders;
+    std::atomic<int> pendingProgram { -1 };
+
+    std::atomic<juce::int64> numMessages { 0 }, numBundles { 0 }, numErrors { 0 };
+    std::atomic<juce::int64> totalLatencyNanos { 0 }, maxLatencyNanos { 0 };
+    double startTime = 0.0;
+
+    void oscMessageReceived (const juce::OSCMessage& message) override;
+    void oscBundleReceived (const juce::OSCBundle& bundle) override;
+    void addBundle (const juce::OSCBundle& bundle, juce::MidiBuffer& buffer);
+    bool addMessage (const juce::OSCMessage& message, juce::MidiBuffer& buffer);
+    void recordLatency (double startMillis, int numMessages);
+
+    void refreshMapping();
+    void deviceChanged() override;
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override { refreshMapping(); }
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override { refreshMapping(); }
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE (OscServer)
+};
+
+} // namespace vmc
@@ -0,0 +1,118 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "paintprofiler.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int profilerLineHeight = 14;
+static constexpr int profilerWidth = 420;
+} // namespace detail
+
+void PaintProfiler::add (const juce::String& name, PaintStats& stats)
+{
+    entries.push_back ({ name, &stats });
+}
+
+void PaintProfiler::reset()
+{
+    for (auto& entry : entries)
+        entry.stats->reset();
+}
+
+juce::StringArray PaintProfiler::getSummary() const
+{
+    juce::StringArray lines;
+    lines.add ("component          count   avg ms   p99 ms   max ms");
+    for (const auto& entry : entries) {
+        const auto& stats = *entry.stats;
+        lines.add (entry.name.paddedRight (' ', 16)
+                   + juce::String (stats.count).paddedLeft (' ', 8)
+                   + juce::String (stats.getRollingAverage(), 3).paddedLeft (' ', 9)
+                   + juce::String (stats.getPercentile (99.0), 3).paddedLeft (' ', 9)
+                   + juce::String (stats.maxMs, 3).paddedLeft (' ', 9));
+    }
+    return lines;
+}
+
+juce::String PaintProfiler::toCsv() const
+{
+    juce::String csv ("component,count,average_ms,rolling_average_ms,p50_ms,p99_ms,max_ms,last_ms\n");
+    for (const auto& entry : entries) {
+        const auto& stats = *entry.stats;
+        csv << entry.name << ","
+            << stats.count << ","
+            << juce::String (stats.getAverage(), 4) << ","
+            << juce::String (stats.getRollingAverage(), 4) << ","
+            << juce::String (stats.getPercentile (50.0), 4) << ","
+            << juce::String (stats.getPercentile (99.0), 4) << ","
+            << juce::String (stats.maxMs, 4) << ","
+            << juce::String (stats.lastMs, 4) << "\n";
+    }
+    return csv;
+}
+
+juce::var PaintProfiler::toVar() const
+{
+    juce::Array<juce::var> out;
+    for (const auto& entry : entries) {
+        const auto& stats = *entry.stats;
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty ("component", entry.name);
+        obj->setProperty ("count", stats.count);
+        obj->setProperty ("average_ms", stats.getAverage());
+        obj->setProperty ("p50_ms", stats.getPercentile (50.0));
+        obj->setProperty ("p99_ms", stats.getPercentile (99.0));
+        obj->setProperty ("max_ms", stats.maxMs);
+        out.add (obj);
+    }
+    return out;
+}
+
+//==============================================================================
+PaintProfilerOverlay::PaintProfilerOverlay (PaintProfiler& p)
+    : profiler (p)
+{
+    // Opaque so refreshing the overlay doesn't repaint, and time, what's underneath.
+    setOpaque (true);
+    setInterceptsMouseClicks (false, false);
+    timerCallback();
+    startTimerHz (4);
+}
+
+PaintProfilerOverlay::~PaintProfilerOverlay()
+{
+    stopTimer();
+}
+
+juce::Rectangle<int> PaintProfilerOverlay::getIdealBounds() const
+{
+    return { detail::profilerWidth, 8 + lines.size() * detail::profilerLineHeight };
+}
+
+void PaintProfilerOverlay::timerCallback()
+{
+    lines = profiler.getSummary();
+    if (getExtraLines)
+        lines.addArray (getExtraLines());
+
+    if (getHeight() != getIdealBounds().getHeight())
+        setSize (getWidth(), getIdealBounds().getHeight());
+    repaint();
+}
+
+void PaintProfilerOverlay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour::fromRGB (20, 22, 24));
+    g.setColour (juce::Colour::fromRGB (64, 160, 255).withAlpha (0.6f));
+    g.drawRect (getLocalBounds());
+
+    g.setColour (juce::Colours::white.withAlpha (0.9f));
+    g.setFont (juce::Font (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain)));
+
+    auto r = getLocalBounds().reduced (6, 4);
+    for (const auto& line : lines)
+        g.drawText (line, r.removeFromTop (detail::profilerLineHeight), juce::Justification::centredLeft, false);
+}
+
+} // namespace vmc
@@ -0,0 +1,67 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "paintstats.hpp"
+
+namespace vmc {
+
+/** A named list of paint stats from components that time their paint(). */
+class PaintProfiler final {
+public:
+    PaintProfiler() = default;
+
+    /** Adds stats to report, they must outlive the profiler's use of them. */
+    void add (const juce::String& name, PaintStats& stats);
+
+    /** Resets all stats. */
+    void reset();
+
+    /** Returns one line per component: name, count, averages, p99 and max. */
+    juce::StringArray getSummary() const;
+
+    /** Returns the stats as CSV with a header row. */
+    juce::String toCsv() const;
+
+    /** Returns the stats as an array of objects, for JSON. */
+    juce::var toVar() const;
+
+private:
+    struct Entry {
+        juce::String name;
+        PaintStats* stats = nullptr;
+    };
+    std::vector<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE (PaintProfiler)
+};
+
+/** Draws a profiler's summary on top of the UI, refreshed a few times a second. */
+class PaintProfilerOverlay final : public juce::Component,
+                                   private juce::Timer {
+public:
+    explicit PaintProfilerOverlay (PaintProfiler& profiler);
+    ~PaintProfilerOverlay() override;
+
+    /** Extra lines shown under the summary. */
+    std::function<juce::StringArray()> getExtraLines;
+
+    /** Returns the size needed to show everything. */
+    juce::Rectangle<int> getIdealBounds() const;
+
+    void paint (juce::Graphics& g) override;
+
+private:
+    PaintProfiler& profiler;
+    juce::StringArray lines;
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE (PaintProfilerOverlay)
+};
+
+} // namespace vmc
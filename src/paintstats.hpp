@@ -0,0 +1,87 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+/** Counts paint calls and how long they took, keeping the most recent times
+    for rolling averages and percentiles. Message thread only.
+*/
+struct PaintStats {
+    static constexpr int windowSize = 256;
+
+    juce::int64 count = 0;
+    double lastMs = 0.0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    std::array<float, windowSize> window {};
+    int windowCount = 0;
+    int windowPosition = 0;
+
+    void add (double ms) noexcept
+    {
+        ++count;
+        lastMs = ms;
+        totalMs += ms;
+        maxMs = juce::jmax (maxMs, ms);
+
+        window[(size_t) windowPosition] = (float) ms;
+        windowPosition = (windowPosition + 1) % windowSize;
+        windowCount = juce::jmin (windowCount + 1, windowSize);
+    }
+
+    void reset() noexcept { *this = {}; }
+
+    double getAverage() const noexcept { return count > 0 ? totalMs / (double) count : 0.0; }
+
+    /** Returns the average of the recent paints. */
+    double getRollingAverage() const noexcept
+    {
+        if (windowCount == 0)
+            return 0.0;
+        double sum = 0.0;
+        for (int i = 0; i < windowCount; ++i)
+            sum += (double) window[(size_t) i];
+        return sum / (double) windowCount;
+    }
+
+    /** Returns a percentile (0-100) of the recent paints. */
+    double getPercentile (double percentile) const
+    {
+        if (windowCount == 0)
+            return 0.0;
+        std::array<float, windowSize> sorted = window;
+        const auto rank = (size_t) juce::jlimit (0, windowCount - 1, (int) std::ceil (percentile * 0.01 * windowCount) - 1);
+        std::nth_element (sorted.begin(), sorted.begin() + (std::ptrdiff_t) rank, sorted.begin() + windowCount);
+        return (double) sorted[rank];
+    }
+
+    juce::String toString() const
+    {
+        juce::String text;
+        text << count << " paints, avg " << juce::String (getAverage(), 3)
+             << " ms, max " << juce::String (maxMs, 3)
+             << " ms, last " << juce::String (lastMs, 3) << " ms";
+        return text;
+    }
+};
+
+/** Times the enclosing scope into a PaintStats. */
+class ScopedPaintTimer final {
+public:
+    explicit ScopedPaintTimer (PaintStats& s) noexcept
+        : stats (s), start (juce::Time::getMillisecondCounterHiRes()) {}
+
+    ~ScopedPaintTimer() { stats.add (juce::Time::getMillisecondCounterHiRes() - start); }
+
+private:
+    PaintStats& stats;
+    const double start;
+    JUCE_DECLARE_NON_COPYABLE (ScopedPaintTimer)
+};
+
+} // namespace vmc
@@ -0,0 +1,239 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pluginchaincomponent.hpp"
+#include "controller.hpp"
+#include "engine.hpp"
+#include "pluginscanner.hpp"
+
+namespace vmc {
+namespace detail {
+/** Shows a plugin's editor, or a generic one, and asks to be closed by its owner. */
+class PluginEditorWindow final : public juce::DocumentWindow {
+public:
+    PluginEditorWindow (juce::AudioPluginInstance& plugin, std::function<void()> onClose)
+        : juce::DocumentWindow (plugin.getName(), juce::Colour::fromRGB (45, 48, 52), juce::DocumentWindow::closeButton),
+          closed (std::move (onClose))
+    {
+        setUsingNativeTitleBar (true);
+        auto* editor = plugin.hasEditor() ? plugin.createEditorAndMakeVisible() : nullptr;
+        setContentOwned (editor != nullptr ? editor : new juce::GenericAudioProcessorEditor (plugin), true);
+        setResizable (false, false);
+    }
+
+    juce::AudioProcessor* getProcessor() const
+    {
+        auto* editor = dynamic_cast<juce::AudioProcessorEditor*> (getContentComponent());
+        return editor != nullptr ? editor->getAudioProcessor() : nullptr;
+    }
+
+    void closeButtonPressed() override { closed(); }
+
+private:
+    std::function<void()> closed;
+};
+} // namespace detail
+
+class PluginChainComponent::ListModel final : public juce::ListBoxModel {
+public:
+    std::function<int()> getNumRowsFunction;
+    std::function<juce::String (int)> getTextFunction;
+    std::function<void (int)> onDoubleClick;
+
+    int getNumRows() override { return getNumRowsFunction(); }
+
+    void paintListBoxItem (int row, juce::Graphics& g, int width, int height, bool selected) override
+    {
+        if (selected)
+            g.fillAll (juce::Colours::white.withAlpha (0.15f));
+        g.setColour (juce::Colours::white.withAlpha (0.9f));
+        g.setFont (juce::Font (juce::FontOptions (13.0f)));
+        g.drawText (getTextFunction (row), 6, 0, width - 12, height, juce::Justification::centredLeft, true);
+    }
+
+    void listBoxItemDoubleClicked (int row, const juce::MouseEvent&) override
+    {
+        if (onDoubleClick)
+            onDoubleClick (row);
+    }
+};
+
+PluginChainComponent::PluginChainComponent (Controller& c)
+    : controller (c),
+      knownModel (std::make_unique<ListModel>()),
+      chainModel (std::make_unique<ListModel>())
+{
+    knownModel->getNumRowsFunction = [this]() { return types.size(); };
+    knownModel->getTextFunction = [this] (int row) {
+        const auto& type = types.getReference (row);
+        return type.name + " (" + type.pluginFormatName + ", " + type.manufacturerName + ")";
+    };
+    knownModel->onDoubleClick = [this] (int) { addSelected(); };
+
+    chainModel->getNumRowsFunction = [this]() { return controller.getEngine().getNumPlugins(); };
+    chainModel->getTextFunction = [this] (int row) {
+        auto* plugin = controller.getEngine().getPlugin (row);
+        return plugin != nullptr ? juce::String (row + 1) + ". " + plugin->getName() : juce::String();
+    };
+    chainModel->onDoubleClick = [this] (int) { editSelected(); };
+
+    for (auto* list : { &known, &chain }) {
+        addAndMakeVisible (list);
+        list->setRowHeight (22);
+        list->setColour (juce::ListBox::backgroundColourId, juce::Colours::black.withAlpha (0.25f));
+    }
+    known.setModel (knownModel.get());
+    chain.setModel (chainModel.get());
+
+    addAndMakeVisible (scanButton);
+    scanButton.setButtonText ("Scan");
+    scanButton.onClick = [this]() { controller.getPluginScanner().start(); };
+
+    addAndMakeVisible (addButton);
+    addButton.setButtonText ("Add");
+    addButton.onClick = [this]() { addSelected(); };
+
+    addAndMakeVisible (removeButton);
+    removeButton.setButtonText ("Remove");
+    removeButton.onClick = [this]() { removeSelected(); };
+
+    addAndMakeVisible (editButton);
+    editButton.setButtonText ("Edit");
+    editButton.onClick = [this]() { editSelected(); };
+
+    timerCallback();
+    startTimerHz (4);
+    setSize (640, 360);
+}
+
+PluginChainComponent::~PluginChainComponent()
+{
+    stopTimer();
+    editors.clear();
+    known.setModel (nullptr);
+    chain.setModel (nullptr);
+}
+
+void PluginChainComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour::fromRGB (45, 48, 52));
+
+    g.setColour (juce::Colours::white.withAlpha (0.8f));
+    g.setFont (juce::Font (juce::FontOptions (12.0f)));
+    auto r = getLocalBounds().reduced (8).removeFromTop (24);
+    r.removeFromLeft (scanButton.getWidth() + 8);
+    g.drawText (status, r, juce::Justification::centredLeft, true);
+}
+
+void PluginChainComponent::resized()
+{
+    auto r = getLocalBounds().reduced (8);
+    scanButton.setBounds (r.removeFromTop (24).removeFromLeft (80));
+    r.removeFromTop (8);
+
+    auto buttons = r.removeFromBottom (24);
+    r.removeFromBottom (8);
+    const int half = (r.getWidth() - 8) / 2;
+    known.setBounds (r.removeFromLeft (half));
+    chain.setBounds (r.removeFromRight (half));
+
+    addButton.setBounds (buttons.removeFromLeft (80));
+    buttons.removeFromLeft (buttons.getWidth() - half);
+    removeButton.setBounds (buttons.removeFromLeft (80));
+    buttons.removeFromLeft (6);
+    editButton.setBounds (buttons.removeFromLeft (80));
+}
+
+void PluginChainComponent::addSelected()
+{
+    const int row = known.getSelectedRow();
+    if (! juce::isPositiveAndBelow (row, types.size()))
+        return;
+
+    const auto error = controller.addPlugin (types.getReference (row));
+    if (error.isNotEmpty()) {
+        auto options = juce::MessageBoxOptions::makeOptionsOk (
+            juce::MessageBoxIconType::WarningIcon,
+            "Add Plugin Failed",
+            error,
+            {},
+            this);
+        juce::AlertWindow::showAsync (options, nullptr);
+    }
+    chain.updateContent();
+    chain.selectRow (controller.getEngine().getNumPlugins() - 1);
+}
+
+void PluginChainComponent::removeSelected()
+{
+    const int row = chain.getSelectedRow();
+    if (auto* plugin = controller.getEngine().getPlugin (row)) {
+        // The editor must go before its plugin.
+        closeEditor (*plugin);
+        controller.removePlugin (row);
+        chain.updateContent();
+        repaint();
+    }
+}
+
+void PluginChainComponent::editSelected()
+{
+    auto* plugin = controller.getEngine().getPlugin (chain.getSelectedRow());
+    if (plugin == nullptr)
+        return;
+
+    for (auto* window : editors) {
+        if (static_cast<detail::PluginEditorWindow*> (window)->getProcessor() == plugin) {
+            window->toFront (true);
+            return;
+        }
+    }
+
+    // Closed later, as the window can't delete itself from its own callback.
+    auto* window = editors.add (new detail::PluginEditorWindow (*plugin, [this, plugin]() {
+        juce::MessageManager::callAsync ([safe = juce::Component::SafePointer<PluginChainComponent> (this), plugin]() {
+            if (safe != nullptr)
+                safe->closeEditor (*plugin);
+        });
+    }));
+    window->centreAroundComponent (this, window->getWidth(), window->getHeight());
+    window->setVisible (true);
+}
+
+void PluginChainComponent::closeEditor (juce::AudioProcessor& plugin)
+{
+    for (int i = editors.size(); --i >= 0;)
+        if (static_cast<detail::PluginEditorWindow*> (editors.getUnchecked (i))->getProcessor() == &plugin)
+            editors.remove (i);
+}
+
+void PluginChainComponent::timerCallback()
+{
+    auto& list = controller.getKnownPlugins();
+    auto& scanner = controller.getPluginScanner();
+
+    if (list.getNumTypes() != types.size()) {
+        types = list.getTypes();
+        known.updateContent();
+        known.repaint();
+    }
+
+    juce::String text;
+    if (scanner.isScanning()) {
+        text << "Scanning " << scanner.getNumScanned() << " of " << scanner.getNumToScan() << "...";
+    } else {
+        text << types.size() << " plugins, " << list.getBlacklistedFiles().size() << " blocklisted";
+        if (scanner.getNumFailed() > 0)
+            text << ", " << scanner.getNumFailed() << " failed in the last scan";
+    }
+    if (controller.isMidiOnly() && controller.getEngine().hasPlugins())
+        text << ". The chain is bypassed while MIDI only.";
+
+    scanButton.setEnabled (! scanner.isScanning());
+    if (text != status) {
+        status = text;
+        repaint();
+    }
+}
+
+} // namespace vmc
@@ -0,0 +1,46 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace vmc {
+
+class Controller;
+
+/** Lists the scanned plugins and the engine's MIDI chain, to scan, add,
+    remove and edit plugins.
+*/
+class PluginChainComponent : public juce::Component,
+                             private juce::Timer {
+public:
+    PluginChainComponent (Controller& controller);
+    ~PluginChainComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    class ListModel;
+
+    Controller& controller;
+    juce::Array<juce::PluginDescription> types;
+    std::unique_ptr<ListModel> knownModel, chainModel;
+    juce::ListBox known, chain;
+    juce::TextButton scanButton, addButton, removeButton, editButton;
+    juce::String status;
+    juce::OwnedArray<juce::DocumentWindow> editors;
+
+    void addSelected();
+    void removeSelected();
+    void editSelected();
+    void closeEditor (juce::AudioProcessor& plugin);
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginChainComponent)
+};
+
+} // namespace vmc
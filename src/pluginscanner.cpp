@@ -0,0 +1,184 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pluginscanner.hpp"
+#include "controller.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int scanPollInterval = 20;
+} // namespace detail
+
+struct PluginScanner::Job {
+    juce::AudioPluginFormat* format = nullptr;
+    juce::String fileOrIdentifier;
+    juce::File output;
+    juce::ChildProcess process;
+    double started = 0.0;
+};
+
+PluginScanner::PluginScanner (juce::AudioPluginFormatManager& f, juce::KnownPluginList& l)
+    : juce::Thread ("VMC Plugin Scanner"),
+      formats (f),
+      list (l)
+{
+}
+
+PluginScanner::~PluginScanner()
+{
+    stop();
+}
+
+void PluginScanner::start()
+{
+    if (isThreadRunning())
+        return;
+
+    numToScan = 0;
+    numScanned = 0;
+    numFailed = 0;
+    startThread();
+}
+
+void PluginScanner::stop()
+{
+    stopThread (5000);
+}
+
+juce::File PluginScanner::getDefaultCacheFile()
+{
+    return Controller::getUserDataPath().getChildFile ("plugins.xml");
+}
+
+bool PluginScanner::loadCache()
+{
+    if (auto xml = juce::parseXML (getDefaultCacheFile())) {
+        list.recreateFromXml (*xml);
+        return true;
+    }
+    return false;
+}
+
+bool PluginScanner::saveCache() const
+{
+    if (auto xml = list.createXml())
+        return xml->writeTo (getDefaultCacheFile());
+    return false;
+}
+
+int PluginScanner::scanInChildProcess (const juce::ArgumentList& args)
+{
+    juce::AudioPluginFormatManager childFormats;
+    childFormats.addDefaultFormats();
+
+    const auto formatName = args.getValueForOption ("--format");
+    const auto fileOrIdentifier = args.getValueForOption ("--plugin");
+    const juce::File output (args.getValueForOption ("--scan-output"));
+
+    for (auto* format : childFormats.getFormats()) {
+        if (format->getName() != formatName)
+            continue;
+
+        juce::OwnedArray<juce::PluginDescription> found;
+        format->findAllTypesForFile (found, fileOrIdentifier);
+
+        juce::XmlElement xml ("PLUGINS");
+        for (auto* description : found)
+            xml.addChildElement (description->createXml().release());
+        return xml.writeTo (output) ? 0 : 1;
+    }
+
+    return 1;
+}
+
+bool PluginScanner::finish (Job& job)
+{
+    // A crash or a kill leaves a non-zero exit code and no usable output.
+    if (job.process.getExitCode() != 0)
+        return false;
+
+    const auto xml = juce::parseXML (job.output);
+    if (xml == nullptr || ! xml->hasTagName ("PLUGINS"))
+        return false;
+
+    for (auto* element : xml->getChildIterator()) {
+        juce::PluginDescription description;
+        if (description.loadFromXml (*element))
+            list.addType (description);
+    }
+    return true;
+}
+
+void PluginScanner::run()
+{
+    std::vector<std::pair<juce::AudioPluginFormat*, juce::String>> pending;
+    const auto blocklisted = list.getBlacklistedFiles();
+    for (auto* format : formats.getFormats()) {
+        if (! format->canScanForPlugins())
+            continue;
+        for (const auto& id : format->searchPathsForPlugins (format->getDefaultLocationsToSearch(), true, false))
+            if (! blocklisted.contains (id) && ! list.isListingUpToDate (id, *format))
+                pending.emplace_back (format, id);
+    }
+    numToScan = (int) pending.size();
+
+    const auto executable = juce::File::getSpecialLocation (juce::File::currentExecutableFile).getFullPathName();
+    const int maxRunning = juce::jmax (1, juce::SystemStats::getNumCpus());
+    std::vector<std::unique_ptr<Job>> running;
+    size_t next = 0;
+
+    while (! threadShouldExit() && (next < pending.size() || ! running.empty())) {
+        while (next < pending.size() && (int) running.size() < maxRunning) {
+            auto job = std::make_unique<Job>();
+            job->format = pending[next].first;
+            job->fileOrIdentifier = pending[next].second;
+            job->output = juce::File::createTempFile (".xml");
+            ++next;
+
+            const juce::StringArray args { executable,
+                                           "--scan-plugin",
+                                           "--format=" + job->format->getName(),
+                                           "--plugin=" + job->fileOrIdentifier,
+                                           "--scan-output=" + job->output.getFullPathName() };
+            if (! job->process.start (args, 0)) {
+                ++numFailed;
+                ++numScanned;
+                continue;
+            }
+
+            job->started = juce::Time::getMillisecondCounterHiRes();
+            running.push_back (std::move (job));
+        }
+
+        wait (detail::scanPollInterval);
+
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        for (auto it = running.begin(); it != running.end();) {
+            auto& job = **it;
+            const bool timedOut = now - job.started > timeoutSeconds * 1000.0;
+            if (job.process.isRunning() && ! timedOut) {
+                ++it;
+                continue;
+            }
+
+            if (timedOut)
+                job.process.kill();
+            if (! finish (job)) {
+                list.addToBlacklist (job.fileOrIdentifier);
+                ++numFailed;
+            }
+            ++numScanned;
+            job.output.deleteFile();
+            it = running.erase (it);
+        }
+    }
+
+    for (auto& job : running) {
+        job->process.kill();
+        job->output.deleteFile();
+    }
+
+    saveCache();
+}
+
+} // namespace vmc
@@ -0,0 +1,64 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace vmc {
+
+/** Finds VST3 and LV2 plugins without loading them into VMC.
+
+    Each plugin file is opened by a copy of VMC started with --scan-plugin,
+    several at once, so a plugin that hangs or crashes only takes its own
+    scanner down. Those are blocklisted. Results go into a KnownPluginList
+    that is cached on disk, and files that haven't changed since the last
+    scan are skipped.
+*/
+class PluginScanner final : private juce::Thread {
+public:
+    /** Seconds a child may take before it is killed and its plugin blocklisted. */
+    static constexpr int timeoutSeconds = 30;
+
+    PluginScanner (juce::AudioPluginFormatManager& formats, juce::KnownPluginList& list);
+    ~PluginScanner() override;
+
+    /** Scans the default locations of every format in the background. */
+    void start();
+    /** Stops scanning, killing any child still running. */
+    void stop();
+    bool isScanning() const noexcept { return isThreadRunning(); }
+
+    /** Returns the files to scan and how many are done, for progress. */
+    int getNumToScan() const noexcept { return numToScan.load(); }
+    int getNumScanned() const noexcept { return numScanned.load(); }
+    /** Returns how many files crashed, hung or failed in the last scan. */
+    int getNumFailed() const noexcept { return numFailed.load(); }
+
+    /** Reads the cached list, returns false if there wasn't one. */
+    bool loadCache();
+    /** Writes the list and blocklist to the cache. */
+    bool saveCache() const;
+    /** Returns plugins.xml under the user data folder. */
+    static juce::File getDefaultCacheFile();
+
+    /** Scans one file in this process and writes what it found as XML. Run by
+        the child, returns the process exit code.
+    */
+    static int scanInChildProcess (const juce::ArgumentList& args);
+
+private:
+    struct Job;
+
+    juce::AudioPluginFormatManager& formats;
+    juce::KnownPluginList& list;
+    std::atomic<int> numToScan { 0 }, numScanned { 0 }, numFailed { 0 };
+
+    bool finish (Job& job);
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (PluginScanner)
+};
+
+} // namespace vmc
@@ -0,0 +1,239 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "previewsynth.hpp"
+
+namespace vmc {
+
+PreviewSynth::PreviewSynth()
+    : juce::AudioProcessor (BusesProperties().withOutput ("Output", juce::AudioChannelSet::stereo(), true))
+{
+    notes.fill (-1);
+    updateCutoff();
+}
+
+PreviewSynth::~PreviewSynth() = default;
+
+bool PreviewSynth::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    const auto out = layouts.getMainOutputChannelSet();
+    return out == juce::AudioChannelSet::mono() || out == juce::AudioChannelSet::stereo();
+}
+
+int PreviewSynth::getNumActiveVoices() const noexcept
+{
+    return (int) std::count_if (notes.begin(), notes.end(), [] (int note) { return note >= 0; });
+}
+
+void PreviewSynth::prepareToPlay (double sampleRate, int)
+{
+    rate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    attackStep = (float) (1.0 / (attackTime * rate));
+    releaseStep = (float) (1.0 / (releaseTime * rate));
+    scratch.resize ((size_t) scratchSize);
+    updateCutoff();
+    allNotesOff (true);
+}
+
+void PreviewSynth::releaseResources()
+{
+    allNotesOff (true);
+}
+
+void PreviewSynth::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    juce::ScopedNoDenormals noDenormals;
+    buffer.clear();
+
+    // Render up to each event, so notes and controls land on their sample.
+    int position = 0;
+    for (const auto metadata : midi) {
+        const int offset = juce::jlimit (position, buffer.getNumSamples(), metadata.samplePosition);
+        render (buffer, position, offset - position);
+        handleMessage (metadata.getMessage());
+        position = offset;
+    }
+
+    render (buffer, position, buffer.getNumSamples() - position);
+}
+
+void PreviewSynth::handleMessage (const juce::MidiMessage& message)
+{
+    if (message.isNoteOn()) {
+        noteOn (message.getNoteNumber(), message.getFloatVelocity());
+    } else if (message.isNoteOff()) {
+        noteOff (message.getNoteNumber());
+    } else if (message.isPitchWheel()) {
+        const auto semitones = 2.0 * (message.getPitchWheelValue() - 8192) / 8192.0;
+        bend = (float) std::pow (2.0, semitones / 12.0);
+    } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+        allNotesOff (message.isAllSoundOff());
+    } else if (message.isController()) {
+        const auto value = (float) message.getControllerValue() / 127.0f;
+        switch (message.getControllerNumber()) {
+            case 7:
+                volume = value;
+                break;
+            case 74:
+                brightness = value;
+                updateCutoff();
+                break;
+            case 64:
+                sustain = value >= 0.5f;
+                if (! sustain)
+                    for (int i = 0; i < numVoices; ++i)
+                        if (notes[(size_t) i] >= 0 && ! held[(size_t) i])
+                            v.target[i] = 0.0f;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void PreviewSynth::updateCutoff() noexcept
+{
+    // 200 Hz closed to about 13 kHz open.
+    const auto hz = 200.0 * std::pow (2.0, 6.0 * brightness);
+    cutoff = (float) (1.0 - std::exp (-juce::MathConstants<double>::twoPi * juce::jmin (hz, rate * 0.45) / rate));
+}
+
+void PreviewSynth::noteOn (int note, float velocity)
+{
+    // Retrigger the same note, else take the quietest free voice, else steal the oldest.
+    int chosen = -1;
+    for (int i = 0; i < numVoices && chosen < 0; ++i)
+        if (notes[(size_t) i] == note)
+            chosen = i;
+
+    if (chosen < 0)
+        for (int i = 0; i < numVoices; ++i)
+            if (notes[(size_t) i] < 0 && (chosen < 0 || v.level[i] < v.level[chosen]))
+                chosen = i;
+
+    if (chosen < 0)
+        for (int i = 0; i < numVoices; ++i)
+            if (chosen < 0 || ages[(size_t) i] < ages[(size_t) chosen])
+                chosen = i;
+
+    if (notes[(size_t) chosen] != note) {
+        v.phase[chosen] = 0.0f;
+        v.filter[chosen] = 0.0f;
+    }
+
+    // Phase runs from -1 to 1 per cycle.
+    v.increment[chosen] = (float) (2.0 * juce::MidiMessage::getMidiNoteInHertz (note) / rate);
+    v.velocity[chosen] = velocity;
+    v.target[chosen] = 1.0f;
+    notes[(size_t) chosen] = note;
+    held[(size_t) chosen] = true;
+    ages[(size_t) chosen] = nextAge++;
+}
+
+void PreviewSynth::noteOff (int note)
+{
+    for (int i = 0; i < numVoices; ++i) {
+        if (notes[(size_t) i] == note && held[(size_t) i]) {
+            held[(size_t) i] = false;
+            if (! sustain)
+                v.target[i] = 0.0f;
+        }
+    }
+}
+
+void PreviewSynth::allNotesOff (bool immediately)
+{
+    for (int i = 0; i < numVoices; ++i) {
+        held[(size_t) i] = false;
+        v.target[i] = 0.0f;
+        if (immediately) {
+            v.level[i] = 0.0f;
+            notes[(size_t) i] = -1;
+        }
+    }
+    sustain = false;
+}
+
+bool PreviewSynth::isGroupActive (int group) const noexcept
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+        if (notes[(size_t) (group * numLanes + lane)] >= 0)
+            return true;
+    return false;
+}
+
+void PreviewSynth::renderGroup (int group, int numSamples) noexcept
+{
+    const int first = group * numLanes;
+    auto phase = Vec::fromRawArray (v.phase + first);
+    auto level = Vec::fromRawArray (v.level + first);
+    auto filter = Vec::fromRawArray (v.filter + first);
+    const auto target = Vec::fromRawArray (v.target + first);
+    const auto increment = Vec::fromRawArray (v.increment + first) * Vec::expand (bend);
+    const auto velocity = Vec::fromRawArray (v.velocity + first);
+
+    const auto one = Vec::expand (1.0f), two = Vec::expand (2.0f), four = Vec::expand (4.0f);
+    const auto refine = Vec::expand (0.225f);
+    const auto attack = Vec::expand (attackStep), release = Vec::expand (-releaseStep);
+    const auto mix = Vec::expand (brightness), coefficient = Vec::expand (cutoff);
+
+    for (int i = 0; i < numSamples; ++i) {
+        // Linear envelope towards the target, attack and release at their own rates.
+        level += Vec::max (release, Vec::min (attack, target - level));
+
+        // Parabolic sine of pi * phase, refined to within 0.1%, blended towards a saw.
+        auto sine = four * (phase - phase * Vec::abs (phase));
+        sine = refine * (sine * Vec::abs (sine) - sine) + sine;
+        const auto osc = sine + mix * (phase - sine);
+
+        filter += coefficient * (osc - filter);
+        scratch[(size_t) i] += filter * level * velocity;
+
+        phase += increment;
+        phase -= two & Vec::greaterThanOrEqual (phase, one);
+    }
+
+    phase.copyToRawArray (v.phase + first);
+    level.copyToRawArray (v.level + first);
+    filter.copyToRawArray (v.filter + first);
+
+    for (int lane = 0; lane < numLanes; ++lane) {
+        const int index = first + lane;
+        if (notes[(size_t) index] >= 0 && v.level[index] <= 0.0f && v.target[index] <= 0.0f)
+            notes[(size_t) index] = -1;
+    }
+}
+
+void PreviewSynth::render (juce::AudioBuffer<float>& buffer, int start, int numSamples) noexcept
+{
+    const auto gain = 0.1f * volume;
+
+    while (numSamples > 0) {
+        const int count = juce::jmin (numSamples, (int) scratch.size());
+        if (count == 0)
+            return;
+
+        std::fill (scratch.begin(), scratch.begin() + count, Vec::expand (0.0f));
+        bool sounding = false;
+        for (int group = 0; group < numGroups; ++group) {
+            if (isGroupActive (group)) {
+                renderGroup (group, count);
+                sounding = true;
+            }
+        }
+
+        if (sounding) {
+            // One horizontal sum per sample folds the lanes together.
+            auto* left = buffer.getWritePointer (0, start);
+            for (int i = 0; i < count; ++i)
+                left[i] = gain * scratch[(size_t) i].sum();
+            if (buffer.getNumChannels() > 1)
+                juce::FloatVectorOperations::copy (buffer.getWritePointer (1, start), left, count);
+        }
+
+        start += count;
+        numSamples -= count;
+    }
+}
+
+} // namespace vmc
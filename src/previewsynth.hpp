@@ -0,0 +1,97 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+
+namespace vmc {
+
+/** A polyphonic synth for auditioning notes and controls locally.
+
+    Voice state is kept as structure of arrays and rendered a SIMD register of
+    voices at a time: a sine to saw oscillator, a one-pole low pass and a
+    linear envelope. Groups with no sounding voice are skipped. CC 74 sets the
+    brightness, CC 7 the volume, CC 64 sustains, the pitch wheel bends two
+    semitones and CC 120 and 123 silence everything. Nothing is allocated
+    while rendering.
+*/
+class PreviewSynth final : public juce::AudioProcessor {
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int numVoices = 64;
+    static constexpr int numLanes = (int) Vec::size();
+    static constexpr int numGroups = numVoices / numLanes;
+
+    PreviewSynth();
+    ~PreviewSynth() override;
+
+    /** Returns the number of voices sounding, for tests and benchmarks. */
+    int getNumActiveVoices() const noexcept;
+
+    //=========================================================================
+    const juce::String getName() const override { return "Preview Synth"; }
+    void prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+
+    double getTailLengthSeconds() const override { return releaseTime; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+
+    bool hasEditor() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram (int) override {}
+    const juce::String getProgramName (int) override { return {}; }
+    void changeProgramName (int, const juce::String&) override {}
+
+    void getStateInformation (juce::MemoryBlock&) override {}
+    void setStateInformation (const void*, int) override {}
+
+private:
+    static_assert (numVoices % numLanes == 0, "voices must fill whole registers");
+    static constexpr double attackTime = 0.005;
+    static constexpr double releaseTime = 0.15;
+    static constexpr int scratchSize = 256;
+
+    /** Per-voice state, one float per voice so groups load straight into registers. */
+    struct alignas (Vec::SIMDRegisterSize) VoiceArrays {
+        float phase[numVoices] {};
+        float increment[numVoices] {};
+        float level[numVoices] {};
+        float target[numVoices] {};
+        float velocity[numVoices] {};
+        float filter[numVoices] {};
+    };
+
+    VoiceArrays v;
+    std::array<int, numVoices> notes;
+    std::array<bool, numVoices> held {};
+    std::array<juce::uint32, numVoices> ages {};
+    std::vector<Vec> scratch;
+
+    double rate = 44100.0;
+    float attackStep = 0.0f, releaseStep = 0.0f;
+    float volume = 0.8f, brightness = 0.3f, bend = 1.0f, cutoff = 0.0f;
+    bool sustain = false;
+    juce::uint32 nextAge = 0;
+
+    void handleMessage (const juce::MidiMessage& message);
+    void noteOn (int note, float velocity);
+    void noteOff (int note);
+    void allNotesOff (bool immediately);
+    void updateCutoff() noexcept;
+    bool isGroupActive (int group) const noexcept;
+    void renderGroup (int group, int numSamples) noexcept;
+    void render (juce::AudioBuffer<float>& buffer, int start, int numSamples) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (PreviewSynth)
+};
+
+} // namespace vmc
@@ -0,0 +1,140 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "qwertyinput.hpp"
+#include "controller.hpp"
+#include "device.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+namespace detail {
+/** Returns the time the key handler runs, in seconds. JUCE gives key presses
+    no OS timestamp, so time spent waiting in the event queue isn't included.
+*/
+static double keyHandlerTime() noexcept
+{
+    return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+} // namespace detail
+
+QwertyNoteInput::QwertyNoteInput (Controller& c)
+    : controller (c)
+{
+    auto& settings = controller.getSettings();
+    layout = settings.getValue (Settings::qwertyLayout, defaultLayout).toLowerCase();
+    if (layout.isEmpty())
+        layout = defaultLayout;
+    octave = juce::jlimit (0, 9, settings.getInt (Settings::qwertyOctave, octave));
+    velocity = juce::jlimit (1, 127, settings.getInt (Settings::qwertyVelocity, velocity));
+}
+
+QwertyNoteInput::~QwertyNoteInput()
+{
+    releaseAll();
+}
+
+void QwertyNoteInput::setLayout (const juce::String& keys)
+{
+    releaseAll();
+    layout = keys.isNotEmpty() ? keys.toLowerCase() : juce::String (defaultLayout);
+    saveSettings();
+}
+
+void QwertyNoteInput::setOctave (int newOctave)
+{
+    octave = juce::jlimit (0, 9, newOctave);
+    saveSettings();
+}
+
+void QwertyNoteInput::setVelocity (int newVelocity)
+{
+    velocity = juce::jlimit (1, 127, newVelocity);
+    saveSettings();
+}
+
+void QwertyNoteInput::saveSettings()
+{
+    auto& settings = controller.getSettings();
+    settings.set (Settings::qwertyLayout, layout);
+    settings.set (Settings::qwertyOctave, octave);
+    settings.set (Settings::qwertyVelocity, velocity);
+}
+
+void QwertyNoteInput::releaseAll()
+{
+    const auto timestamp = detail::keyHandlerTime();
+    for (const auto& key : held)
+        release (key, timestamp);
+    held.clearQuick();
+}
+
+void QwertyNoteInput::release (const HeldKey& key, double timestamp)
+{
+    controller.playNote (juce::MidiMessage::noteOff (key.channel, key.note).withTimeStamp (timestamp));
+}
+
+bool QwertyNoteInput::keyPressed (const juce::KeyPress& key, juce::Component*)
+{
+    const auto timestamp = detail::keyHandlerTime();
+    const ScopedLatencyTrace trace (controller.getLatencyTracer(), timestamp * 1000.0);
+
+    // Leave shortcuts alone.
+    const auto mods = key.getModifiers();
+    if (mods.isCommandDown() || mods.isCtrlDown() || mods.isAltDown())
+        return false;
+
+    const auto code = key.getKeyCode();
+    if (code <= 0 || code >= 256)
+        return false;
+
+    const auto character = juce::CharacterFunctions::toLowerCase ((juce::juce_wchar) code);
+    const int index = layout.indexOfChar (character);
+
+    if (index < 0) {
+        if (character == 'z')
+            setOctave (octave - 1);
+        else if (character == 'x')
+            setOctave (octave + 1);
+        else if (character == 'c')
+            setVelocity (velocity - 10);
+        else if (character == 'v')
+            setVelocity (velocity + 10);
+        else
+            return false;
+        return true;
+    }
+
+    // Auto-repeat sends the press again while held.
+    for (const auto& h : held)
+        if (h.key == character)
+            return true;
+
+    const int note = octave * 12 + index;
+    if (! juce::isPositiveAndBelow (note, 128))
+        return true;
+
+    const int channel = juce::jlimit (1, 16, controller.device().midiChannel());
+    held.add ({ character, note, channel });
+    controller.playNote (juce::MidiMessage::noteOn (channel, note, (juce::uint8) velocity).withTimeStamp (timestamp));
+    return true;
+}
+
+bool QwertyNoteInput::keyStateChanged (bool, juce::Component*)
+{
+    const auto timestamp = detail::keyHandlerTime();
+    const ScopedLatencyTrace trace (controller.getLatencyTracer(), timestamp * 1000.0);
+    bool used = false;
+
+    for (int i = held.size(); --i >= 0;) {
+        const auto key = held.getUnchecked (i);
+        if (! juce::KeyPress (key.key, 0, 0).isCurrentlyDown()) {
+            release (key, timestamp);
+            held.remove (i);
+            used = true;
+        }
+    }
+
+    return used;
+}
+
+} // namespace vmc
@@ -0,0 +1,69 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace vmc {
+
+class Controller;
+
+/** Plays notes from the computer keyboard.
+
+    Attach it to a window as a key listener. Notes go straight to the MIDI
+    sender stamped with the time the key handler ran, then the keyboard state
+    is updated for display only, so note latency doesn't depend on painting.
+    JUCE gives key presses no OS timestamp, so that time and the latency
+    tracer's input stage leave out the wait in the event queue.
+    Keys typed into a focused text field are not played.
+
+    Each character of the layout is a semitone up from C of the current
+    octave. Z and X change the octave, C and V change the velocity.
+*/
+class QwertyNoteInput final : public juce::KeyListener {
+public:
+    static constexpr const char* defaultLayout = "awsedftgyhujkolp;'";
+
+    explicit QwertyNoteInput (Controller& controller);
+    ~QwertyNoteInput() override;
+
+    /** Sets the keys to play, one per semitone. */
+    void setLayout (const juce::String& keys);
+    juce::String getLayout() const { return layout; }
+
+    /** Sets the octave of the first key, 0-9. */
+    void setOctave (int newOctave);
+    int getOctave() const noexcept { return octave; }
+
+    /** Sets the note on velocity, 1-127. */
+    void setVelocity (int newVelocity);
+    int getVelocity() const noexcept { return velocity; }
+
+    /** Releases any notes being held. */
+    void releaseAll();
+
+    bool keyPressed (const juce::KeyPress& key, juce::Component* originatingComponent) override;
+    bool keyStateChanged (bool isKeyDown, juce::Component* originatingComponent) override;
+
+private:
+    struct HeldKey {
+        juce::juce_wchar key;
+        int note;
+        int channel;
+    };
+
+    Controller& controller;
+    juce::String layout { defaultLayout };
+    int octave = 5;
+    int velocity = 100;
+    juce::Array<HeldKey> held;
+
+    void release (const HeldKey& key, double timestamp);
+    void saveSettings();
+
+    JUCE_DECLARE_NON_COPYABLE (QwertyNoteInput)
+};
+
+} // namespace vmc
@@ -0,0 +1,509 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sampleplayer.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int firstUnnamedKey = 36;
+
+/** Parses a note name like C4, F#3 or Db2, where C4 is 60. */
+static int parseNoteName (const juce::String& token)
+{
+    static const int semitones[] = { 9, 11, 0, 2, 4, 5, 7 }; // A to G
+    const auto letter = juce::CharacterFunctions::toUpperCase (token[0]);
+    if (letter < 'A' || letter > 'G')
+        return -1;
+
+    int note = semitones[letter - 'A'];
+    int index = 1;
+    if (token[index] == '#' || token[index] == 's') {
+        ++note;
+        ++index;
+    } else if (token[index] == 'b') {
+        --note;
+        ++index;
+    }
+
+    const auto octave = token.substring (index);
+    if (octave.isEmpty() || ! octave.containsOnly ("0123456789"))
+        return -1;
+
+    note += (octave.getIntValue() + 1) * 12;
+    return juce::isPositiveAndBelow (note, 128) ? note : -1;
+}
+} // namespace detail
+
+//==============================================================================
+struct SamplePlayer::Sample {
+    juce::String name;
+    int rootNote = 60;
+    double sampleRate = 44100.0;
+    juce::int64 length = 0;
+    /** The start of the sample, always in memory. */
+    juce::AudioBuffer<float> attack;
+    int attackLength = 0;
+    /** Reads the rest, only used by the background thread. */
+    std::unique_ptr<juce::AudioFormatReader> reader;
+};
+
+struct SamplePlayer::SampleSet {
+    std::vector<std::unique_ptr<Sample>> samples;
+    std::array<const Sample*, 128> keys {};
+};
+
+struct SamplePlayer::Stream {
+    enum State {
+        idle = 0,
+        requested,
+        streaming,
+        stopping
+    };
+
+    /** Idle streams belong to the audio thread, the others to the streamer
+        until it sees stopping and hands them back as idle.
+    */
+    std::atomic<int> state { idle };
+    const Sample* sample = nullptr;
+    const SampleSet* set = nullptr;
+    juce::AbstractFifo fifo { streamFrames };
+    juce::AudioBuffer<float> ring { 2, streamFrames };
+    juce::int64 nextRead = 0; // streamer only
+};
+
+struct SamplePlayer::Voice {
+    const Sample* sample = nullptr;
+    Stream* stream = nullptr;
+    int note = -1;
+    bool held = false;
+    double position = 0.0, increment = 1.0;
+    float gain = 0.0f, level = 0.0f, target = 0.0f;
+    juce::int64 consumed = 0;
+    juce::uint32 age = 0;
+};
+
+//==============================================================================
+SamplePlayer::SamplePlayer()
+    : juce::AudioProcessor (BusesProperties().withOutput ("Output", juce::AudioChannelSet::stereo(), true)),
+      juce::Thread ("VMC Sample Streamer"),
+      voices (new Voice[(size_t) numVoices])
+{
+    formats.registerBasicFormats();
+    for (int i = 0; i < numStreams; ++i)
+        streams.add (new Stream());
+}
+
+SamplePlayer::~SamplePlayer()
+{
+    stopThread (2000);
+    delete pending.exchange (nullptr);
+    delete retired.exchange (nullptr);
+    delete current;
+}
+
+bool SamplePlayer::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    const auto out = layouts.getMainOutputChannelSet();
+    return out == juce::AudioChannelSet::mono() || out == juce::AudioChannelSet::stereo();
+}
+
+int SamplePlayer::parseRootNote (const juce::String& fileName)
+{
+    auto tokens = juce::StringArray::fromTokens (fileName.upToLastOccurrenceOf (".", false, false), "_- .", {});
+    tokens.removeEmptyStrings();
+
+    // The note is usually last, after the instrument and articulation.
+    for (int i = tokens.size(); --i >= 0;) {
+        const auto& token = tokens.getReference (i);
+        if (token.containsOnly ("0123456789")) {
+            const int note = token.getIntValue();
+            if (juce::isPositiveAndBelow (note, 128))
+                return note;
+        } else if (const int note = detail::parseNoteName (token); note >= 0) {
+            return note;
+        }
+    }
+
+    return -1;
+}
+
+juce::File SamplePlayer::getFolder() const
+{
+    const juce::ScopedLock sl (requestLock);
+    return folder;
+}
+
+void SamplePlayer::loadFolder (const juce::File& newFolder)
+{
+    {
+        const juce::ScopedLock sl (requestLock);
+        folder = newFolder;
+        loadRequested = true;
+    }
+
+    if (! isThreadRunning())
+        startThread();
+    notify();
+}
+
+//==============================================================================
+std::unique_ptr<SamplePlayer::SampleSet> SamplePlayer::loadSet (const juce::File& dir)
+{
+    auto set = std::make_unique<SampleSet>();
+    auto files = dir.findChildFiles (juce::File::findFiles, false, formats.getWildcardForAllFormats());
+    files.sort();
+
+    int nextUnnamed = detail::firstUnnamedKey;
+    for (const auto& file : files) {
+        if (threadShouldExit())
+            return nullptr;
+
+        auto* format = formats.findFormatForFileExtension (file.getFileExtension());
+        if (format == nullptr)
+            continue;
+
+        // Memory mapped where the format allows, so streaming costs page faults, not copies.
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        if (std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped { format->createMemoryMappedReader (file) }) {
+            if (mapped->mapEntireFile())
+                reader = std::move (mapped);
+        }
+        if (reader == nullptr)
+            reader.reset (formats.createReaderFor (file));
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            continue;
+
+        auto sample = std::make_unique<Sample>();
+        sample->name = file.getFileName();
+        sample->sampleRate = reader->sampleRate;
+        sample->length = reader->lengthInSamples;
+        sample->attackLength = (int) juce::jmin ((juce::int64) preloadFrames, sample->length);
+        sample->attack.setSize (2, sample->attackLength);
+        reader->read (&sample->attack, 0, sample->attackLength, 0, true, true);
+
+        const int note = parseRootNote (file.getFileName());
+        sample->rootNote = note >= 0 ? note : juce::jmin (127, nextUnnamed++);
+        sample->reader = std::move (reader);
+        set->samples.push_back (std::move (sample));
+    }
+
+    // Each key plays the sample with the nearest root.
+    for (int key = 0; key < 128; ++key) {
+        const Sample* nearest = nullptr;
+        for (const auto& sample : set->samples)
+            if (nearest == nullptr || std::abs (sample->rootNote - key) < std::abs (nearest->rootNote - key))
+                nearest = sample.get();
+        set->keys[(size_t) key] = nearest;
+    }
+
+    return set;
+}
+
+bool SamplePlayer::service (Stream& stream)
+{
+    auto state = stream.state.load (std::memory_order_acquire);
+    if (state == Stream::stopping) {
+        stream.state.store (Stream::idle, std::memory_order_release);
+        return false;
+    }
+
+    if (state == Stream::requested) {
+        stream.nextRead = stream.sample->attackLength;
+        if (! stream.state.compare_exchange_strong (state, Stream::streaming, std::memory_order_acq_rel))
+            return false;
+    } else if (state != Stream::streaming) {
+        return false;
+    }
+
+    const auto& sample = *stream.sample;
+    const auto remaining = sample.length - stream.nextRead;
+    const int count = (int) juce::jmin ((juce::int64) juce::jmin (readFrames, stream.fifo.getFreeSpace()), remaining);
+    if (count <= 0)
+        return false;
+
+    const auto scope = stream.fifo.write (count);
+    if (scope.blockSize1 > 0)
+        sample.reader->read (&stream.ring, scope.startIndex1, scope.blockSize1, stream.nextRead, true, true);
+    if (scope.blockSize2 > 0)
+        sample.reader->read (&stream.ring, scope.startIndex2, scope.blockSize2, stream.nextRead + scope.blockSize1, true, true);
+    stream.nextRead += count;
+    return true;
+}
+
+void SamplePlayer::deleteRetired()
+{
+    auto* old = retired.load (std::memory_order_acquire);
+    if (old == nullptr)
+        return;
+
+    for (auto* stream : streams)
+        if (stream->state.load (std::memory_order_acquire) != Stream::idle && stream->set == old)
+            return;
+
+    retired.store (nullptr, std::memory_order_release);
+    delete old;
+}
+
+void SamplePlayer::run()
+{
+    while (! threadShouldExit()) {
+        juce::File toLoad;
+        {
+            const juce::ScopedLock sl (requestLock);
+            // One set at a time: wait until the audio thread took the last and the one before is gone.
+            if (loadRequested && pending.load() == nullptr && retired.load() == nullptr) {
+                toLoad = folder;
+                loadRequested = false;
+            }
+        }
+
+        if (toLoad != juce::File()) {
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            if (auto set = loadSet (toLoad)) {
+                juce::int64 bytes = 0;
+                for (const auto& sample : set->samples)
+                    bytes += (juce::int64) sample->attack.getNumChannels() * sample->attackLength * (juce::int64) sizeof (float);
+                numSamples = (int) set->samples.size();
+                preloadedBytes = bytes;
+                loadTime = juce::Time::getMillisecondCounterHiRes() - start;
+                pending.store (set.release(), std::memory_order_release);
+            }
+        }
+
+        bool busy = false, active = false;
+        for (auto* stream : streams) {
+            busy = service (*stream) || busy;
+            active = active || stream->state.load (std::memory_order_relaxed) != Stream::idle;
+        }
+        deleteRetired();
+
+        if (busy)
+            continue;
+
+        // Poll tightly only while streaming. Otherwise a stream started by a
+        // note is picked up well within its preloaded attack, and with nothing
+        // loaded or being handed over, loadFolder() wakes the thread.
+        const bool handingOver = pending.load() != nullptr || retired.load() != nullptr;
+        if (active)
+            wait (2);
+        else
+            wait (numSamples.load() > 0 || handingOver ? idleWait.load() : -1);
+    }
+}
+
+//==============================================================================
+void SamplePlayer::prepareToPlay (double sampleRate, int)
+{
+    rate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    idleWait = juce::jmax (2, (int) (preloadFrames * 500.0 / rate));
+    attackStep = (float) (1.0 / (attackTime * rate));
+    releaseStep = (float) (1.0 / (releaseTime * rate));
+}
+
+void SamplePlayer::releaseResources()
+{
+    for (int i = 0; i < numVoices; ++i)
+        stopVoice (voices[(size_t) i]);
+    sustain = false;
+}
+
+void SamplePlayer::swapSets() noexcept
+{
+    if (pending.load (std::memory_order_relaxed) == nullptr || retired.load (std::memory_order_acquire) != nullptr)
+        return;
+
+    for (int i = 0; i < numVoices; ++i)
+        stopVoice (voices[(size_t) i]);
+
+    // The streamer deletes the old set once its streams are idle.
+    retired.store (current, std::memory_order_release);
+    current = pending.exchange (nullptr, std::memory_order_acq_rel);
+}
+
+void SamplePlayer::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    juce::ScopedNoDenormals noDenormals;
+    buffer.clear();
+    swapSets();
+
+    int position = 0;
+    for (const auto metadata : midi) {
+        const int offset = juce::jlimit (position, buffer.getNumSamples(), metadata.samplePosition);
+        render (buffer, position, offset - position);
+        handleMessage (metadata.getMessage());
+        position = offset;
+    }
+
+    render (buffer, position, buffer.getNumSamples() - position);
+}
+
+void SamplePlayer::handleMessage (const juce::MidiMessage& message) noexcept
+{
+    if (message.isNoteOn()) {
+        noteOn (message.getNoteNumber(), message.getFloatVelocity());
+    } else if (message.isNoteOff()) {
+        noteOff (message.getNoteNumber());
+    } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+        for (int i = 0; i < numVoices; ++i) {
+            auto& voice = voices[(size_t) i];
+            voice.held = false;
+            voice.target = 0.0f;
+            if (message.isAllSoundOff())
+                stopVoice (voice);
+        }
+        sustain = false;
+    } else if (message.isSustainPedalOn() || message.isSustainPedalOff()) {
+        sustain = message.isSustainPedalOn();
+        if (! sustain)
+            for (int i = 0; i < numVoices; ++i)
+                if (! voices[(size_t) i].held)
+                    voices[(size_t) i].target = 0.0f;
+    }
+}
+
+void SamplePlayer::noteOn (int note, float velocity) noexcept
+{
+    if (current == nullptr || current->keys[(size_t) note] == nullptr)
+        return;
+
+    Voice* chosen = nullptr;
+    for (int i = 0; i < numVoices && chosen == nullptr; ++i)
+        if (voices[(size_t) i].note == note)
+            chosen = &voices[(size_t) i];
+    for (int i = 0; i < numVoices && chosen == nullptr; ++i)
+        if (voices[(size_t) i].note < 0)
+            chosen = &voices[(size_t) i];
+    if (chosen == nullptr)
+        for (int i = 0; i < numVoices; ++i)
+            if (chosen == nullptr || voices[(size_t) i].age < chosen->age)
+                chosen = &voices[(size_t) i];
+
+    stopVoice (*chosen);
+
+    const auto* sample = current->keys[(size_t) note];
+    auto& voice = *chosen;
+    voice.sample = sample;
+    voice.note = note;
+    voice.held = true;
+    voice.position = 0.0;
+    voice.consumed = 0;
+    voice.increment = std::pow (2.0, (note - sample->rootNote) / 12.0) * sample->sampleRate / rate;
+    voice.gain = velocity * velocity;
+    voice.level = 0.0f;
+    voice.target = 1.0f;
+    voice.age = nextAge++;
+
+    // Claim an idle stream for anything past the attack. Without one, only the attack plays.
+    if (sample->length > sample->attackLength) {
+        for (auto* stream : streams) {
+            if (stream->state.load (std::memory_order_acquire) == Stream::idle) {
+                stream->fifo.reset();
+                stream->sample = sample;
+                stream->set = current;
+                stream->state.store (Stream::requested, std::memory_order_release);
+                voice.stream = stream;
+                break;
+            }
+        }
+    }
+}
+
+void SamplePlayer::noteOff (int note) noexcept
+{
+    for (int i = 0; i < numVoices; ++i) {
+        auto& voice = voices[(size_t) i];
+        if (voice.note == note && voice.held) {
+            voice.held = false;
+            if (! sustain)
+                voice.target = 0.0f;
+        }
+    }
+}
+
+void SamplePlayer::stopVoice (Voice& voice) noexcept
+{
+    if (voice.stream != nullptr)
+        voice.stream->state.store (Stream::stopping, std::memory_order_release);
+    voice.stream = nullptr;
+    voice.sample = nullptr;
+    voice.note = -1;
+    voice.held = false;
+    voice.level = voice.target = 0.0f;
+}
+
+void SamplePlayer::render (juce::AudioBuffer<float>& buffer, int start, int count) noexcept
+{
+    if (count <= 0)
+        return;
+    for (int i = 0; i < numVoices; ++i)
+        if (voices[(size_t) i].note >= 0)
+            renderVoice (voices[(size_t) i], buffer, start, count);
+}
+
+void SamplePlayer::renderVoice (Voice& voice, juce::AudioBuffer<float>& buffer, int start, int count) noexcept
+{
+    const auto& sample = *voice.sample;
+    const int attackLength = sample.attackLength;
+
+    // What the streamer has read so far, from the first frame not yet released.
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    if (voice.stream != nullptr) {
+        auto& fifo = voice.stream->fifo;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+    }
+    const auto ready = (juce::int64) (size1 + size2);
+    bool underrun = false;
+
+    const auto frame = [&] (int channel, juce::int64 index) -> float {
+        if (index < attackLength)
+            return sample.attack.getSample (channel, (int) index);
+        const auto offset = index - attackLength - voice.consumed;
+        if (offset < 0 || offset >= ready) {
+            underrun = true;
+            return 0.0f;
+        }
+        const int ringIndex = offset < size1 ? start1 + (int) offset : start2 + (int) (offset - size1);
+        return voice.stream->ring.getSample (channel, ringIndex);
+    };
+
+    auto* left = buffer.getWritePointer (0, start);
+    auto* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer (1, start) : nullptr;
+
+    for (int i = 0; i < count; ++i) {
+        const auto index = (juce::int64) voice.position;
+        if (index + 1 >= sample.length || (voice.level <= 0.0f && voice.target <= 0.0f)) {
+            stopVoice (voice);
+            return;
+        }
+
+        if (voice.level < voice.target)
+            voice.level = juce::jmin (voice.target, voice.level + attackStep);
+        else if (voice.level > voice.target)
+            voice.level = juce::jmax (voice.target, voice.level - releaseStep);
+
+        const auto fraction = (float) (voice.position - (double) index);
+        const auto gain = voice.gain * voice.level;
+        const auto l0 = frame (0, index), l1 = frame (0, index + 1);
+        const auto r0 = frame (1, index), r1 = frame (1, index + 1);
+        left[i] += gain * (l0 + fraction * (l1 - l0));
+        if (right != nullptr)
+            right[i] += gain * (r0 + fraction * (r1 - r0));
+
+        voice.position += voice.increment;
+    }
+
+    if (underrun)
+        numUnderruns.fetch_add (1, std::memory_order_relaxed);
+
+    // Hand back the streamed frames the playhead has passed.
+    if (voice.stream != nullptr) {
+        const auto passed = (juce::int64) voice.position - attackLength - voice.consumed;
+        const int release = (int) juce::jlimit ((juce::int64) 0, ready, passed);
+        if (release > 0) {
+            voice.stream->fifo.finishedRead (release);
+            voice.consumed += release;
+        }
+    }
+}
+
+} // namespace vmc
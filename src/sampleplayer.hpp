@@ -0,0 +1,125 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace vmc {
+
+/** Plays a folder of samples mapped to keys.
+
+    The root note of each file comes from its name, e.g. "piano_C4.wav" or
+    "kick-036.wav", where C4 is note 60. Keys without a sample play the
+    nearest one, repitched. Files without a note in their name take the
+    keys from 36 up, in name order.
+
+    The first preloadFrames of each sample are read into memory when the
+    folder loads. The rest is streamed by a background thread, from memory
+    mapped files where the format allows, into a ring per stream. The audio
+    thread reads the rings through AbstractFifo without locking. A new
+    sample set is handed over through an atomic pointer, and the old one is
+    deleted by the background thread once no stream uses it.
+*/
+class SamplePlayer final : public juce::AudioProcessor,
+                           private juce::Thread {
+public:
+    static constexpr int numVoices = 32;
+    static constexpr int numStreams = 64;
+    static constexpr int preloadFrames = 16384;
+    static constexpr int streamFrames = 16384;
+    static constexpr int readFrames = 2048;
+
+    SamplePlayer();
+    ~SamplePlayer() override;
+
+    /** Loads every audio file in a folder in the background, then swaps it in. */
+    void loadFolder (const juce::File& folder);
+    /** Returns the folder last asked for. */
+    juce::File getFolder() const;
+
+    /** Returns the number of samples in the playing set. */
+    int getNumSamples() const noexcept { return numSamples.load(); }
+    /** Returns the bytes held in memory for attack segments. */
+    juce::int64 getPreloadedBytes() const noexcept { return preloadedBytes.load(); }
+    /** Returns how often a voice needed audio the streamer hadn't read yet. */
+    juce::int64 getNumUnderruns() const noexcept { return numUnderruns.load(); }
+    /** Returns how long the last folder took to load, in milliseconds. */
+    double getLoadTime() const noexcept { return loadTime.load(); }
+
+    /** Returns the note in a file name, or -1 if there isn't one. */
+    static int parseRootNote (const juce::String& fileName);
+
+    //=========================================================================
+    const juce::String getName() const override { return "Sample Player"; }
+    void prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+
+    double getTailLengthSeconds() const override { return releaseTime; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return false; }
+
+    bool hasEditor() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram (int) override {}
+    const juce::String getProgramName (int) override { return {}; }
+    void changeProgramName (int, const juce::String&) override {}
+
+    void getStateInformation (juce::MemoryBlock&) override {}
+    void setStateInformation (const void*, int) override {}
+
+private:
+    static constexpr double attackTime = 0.002;
+    static constexpr double releaseTime = 0.1;
+
+    struct Sample;
+    struct SampleSet;
+    struct Stream;
+    struct Voice;
+
+    juce::AudioFormatManager formats;
+    juce::CriticalSection requestLock;
+    juce::File folder;
+    bool loadRequested = false;
+
+    // Handoff between the background thread and the audio thread.
+    std::atomic<SampleSet*> pending { nullptr }, retired { nullptr };
+    juce::OwnedArray<Stream> streams;
+
+    // Audio thread only.
+    SampleSet* current = nullptr;
+    std::unique_ptr<Voice[]> voices;
+    double rate = 44100.0;
+    float attackStep = 0.0f, releaseStep = 0.0f;
+    bool sustain = false;
+    juce::uint32 nextAge = 0;
+
+    std::atomic<int> numSamples { 0 };
+    std::atomic<juce::int64> preloadedBytes { 0 }, numUnderruns { 0 };
+    std::atomic<double> loadTime { 0.0 };
+    // Half the preloaded attack in milliseconds, the streamer's poll while idle.
+    std::atomic<int> idleWait { (int) (preloadFrames * 500.0 / 44100.0) };
+
+    std::unique_ptr<SampleSet> loadSet (const juce::File& folder);
+    bool service (Stream& stream);
+    void deleteRetired();
+    void run() override;
+
+    void swapSets() noexcept;
+    void handleMessage (const juce::MidiMessage& message) noexcept;
+    void noteOn (int note, float velocity) noexcept;
+    void noteOff (int note) noexcept;
+    void stopVoice (Voice& voice) noexcept;
+    void render (juce::AudioBuffer<float>& buffer, int start, int numSamples) noexcept;
+    void renderVoice (Voice& voice, juce::AudioBuffer<float>& buffer, int start, int numSamples) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (SamplePlayer)
+};
+
+} // namespace vmc
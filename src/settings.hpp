@@ -13,8 +13,28 @@ public:
     static const char* lastMidiProgram;
     static constexpr const char* dialMidiCCs = "dialMidiCCs";
     static constexpr const char* currentDrawer = "currentDrawer";
+    static constexpr const char* sysexBytesPerSecond = "sysexBytesPerSecond";
+    static constexpr const char* librarianPacketInterval = "librarianPacketInterval";
+    static constexpr const char* librarianBytesPerSecond = "librarianBytesPerSecond";
+    static constexpr const char* oscPort = "oscPort";
+    static constexpr const char* qwertyLayout = "qwertyLayout";
+    static constexpr const char* qwertyOctave = "qwertyOctave";
+    static constexpr const char* qwertyVelocity = "qwertyVelocity";
+    static constexpr const char* stallWatchdog = "stallWatchdog";
+    static constexpr const char* stallThreshold = "stallThreshold";
+    static constexpr const char* localMonitor = "localMonitor";
+    static constexpr const char* monitorSamples = "monitorSamples";
+    static constexpr const char* midiOnly = "midiOnly";
 
     Settings()
+    {
+        setStorageParameters (getDefaultOptions());
+    }
+
+    ~Settings() {}
+
+    /** Returns where the app keeps its settings. */
+    static PropertiesFile::Options getDefaultOptions()
     {
         PropertiesFile::Options opts;
         opts.applicationName = "virtual-midi-controller";
@@ -33,10 +53,18 @@ public:
         opts.folderName = "Kushview/Virtual MIDI Controller";
 #endif
 
-        setStorageParameters (opts);
+        return opts;
     }
 
-    ~Settings() {}
+    /** Returns options that keep the settings in a folder of their own, so
+        tests and benchmarks don't read or change the user's.
+    */
+    static PropertiesFile::Options getOptionsInFolder (const File& folder)
+    {
+        auto opts = getDefaultOptions();
+        opts.folderName = folder.getFullPathName();
+        return opts;
+    }
 
     void set (const String& key, const var& value)
     {
@@ -0,0 +1,262 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sharedmidiring.hpp"
+
+#if ! JUCE_WINDOWS
+    #include <fcntl.h>
+    #include <semaphore.h>
+    #include <sys/mman.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+#if JUCE_MAC
+    #include <poll.h>
+    #include <sys/stat.h>
+#endif
+
+namespace vmc {
+namespace detail {
+static_assert (std::atomic<juce::uint64>::is_always_lock_free,
+               "the ring needs lock free 64-bit atomics to be shared between processes");
+
+#if JUCE_MAC
+// macOS has no sem_timedwait, the reader blocks in poll() on a named pipe instead.
+static std::string wakePipePath (const juce::String& name)
+{
+    return ("/tmp" + name + "-wake").toStdString();
+}
+#elif ! JUCE_WINDOWS
+static std::string semaphoreName (const juce::String& name)
+{
+    return (name + "-wake").toStdString();
+}
+#endif
+} // namespace detail
+
+SharedMidiRing::~SharedMidiRing()
+{
+#if ! JUCE_WINDOWS
+    if (header != nullptr)
+        munmap (header, mappedSize);
+    #if JUCE_MAC
+    if (wakePipe >= 0)
+        close (wakePipe);
+    #else
+    if (semaphore != nullptr)
+        sem_close (static_cast<sem_t*> (semaphore));
+    #endif
+
+    if (owner) {
+        shm_unlink (name.toRawUTF8());
+    #if JUCE_MAC
+        unlink (detail::wakePipePath (name).c_str());
+    #else
+        sem_unlink (detail::semaphoreName (name).c_str());
+    #endif
+    }
+#endif
+}
+
+std::unique_ptr<SharedMidiRing> SharedMidiRing::create (const juce::String& name, int capacity)
+{
+#if JUCE_WINDOWS
+    juce::ignoreUnused (name, capacity);
+    return nullptr;
+#else
+    const auto ringCapacity = (juce::uint32) juce::nextPowerOfTwo (juce::jmax (4096, capacity));
+    const auto size = sizeof (Header) + ringCapacity;
+
+    // A ring left behind by a crashed instance is replaced.
+    shm_unlink (name.toRawUTF8());
+    #if JUCE_MAC
+    unlink (detail::wakePipePath (name).c_str());
+    #else
+    sem_unlink (detail::semaphoreName (name).c_str());
+    #endif
+
+    const int fd = shm_open (name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+
+    std::unique_ptr<SharedMidiRing> ring (new SharedMidiRing());
+    ring->name = name;
+    ring->owner = true;
+
+    void* memory = MAP_FAILED;
+    if (ftruncate (fd, (off_t) size) == 0)
+        memory = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close (fd);
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    ring->mappedSize = size;
+    ring->header = new (memory) Header();
+    ring->data = static_cast<juce::uint8*> (memory) + sizeof (Header);
+
+    #if JUCE_MAC
+    // Opened for writing too, so the pipe never reports end of file between writers.
+    const auto pipePath = detail::wakePipePath (name);
+    if (mkfifo (pipePath.c_str(), 0600) != 0)
+        return nullptr;
+    ring->wakePipe = ::open (pipePath.c_str(), O_RDWR | O_NONBLOCK);
+    if (ring->wakePipe < 0)
+        return nullptr;
+    #else
+    auto* sem = sem_open (detail::semaphoreName (name).c_str(), O_CREAT, 0600, 0);
+    if (sem == SEM_FAILED)
+        return nullptr;
+    ring->semaphore = sem;
+    #endif
+
+    auto& h = *ring->header;
+    ring->capacity = ringCapacity;
+    h.capacity = ringCapacity;
+    h.version = version;
+    h.writePosition.store (0);
+    h.readPosition.store (0);
+    h.readerWaiting.store (0);
+    std::atomic_thread_fence (std::memory_order_release);
+    h.magic = magic; // written last, writers check it before anything else
+    return ring;
+#endif
+}
+
+std::unique_ptr<SharedMidiRing> SharedMidiRing::open (const juce::String& name)
+{
+#if JUCE_WINDOWS
+    juce::ignoreUnused (name);
+    return nullptr;
+#else
+    const int fd = shm_open (name.toRawUTF8(), O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+
+    const auto size = (size_t) lseek (fd, 0, SEEK_END);
+    void* memory = size > sizeof (Header)
+                       ? mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+    close (fd);
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    std::unique_ptr<SharedMidiRing> ring (new SharedMidiRing());
+    ring->name = name;
+    ring->mappedSize = size;
+    ring->header = static_cast<Header*> (memory);
+    ring->data = static_cast<juce::uint8*> (memory) + sizeof (Header);
+
+    const auto& h = *ring->header;
+    if (h.magic != magic || h.version != version || sizeof (Header) + h.capacity != size)
+        return nullptr;
+    ring->capacity = h.capacity;
+
+    #if JUCE_MAC
+    ring->wakePipe = ::open (detail::wakePipePath (name).c_str(), O_WRONLY | O_NONBLOCK);
+    if (ring->wakePipe < 0)
+        return nullptr;
+    #else
+    auto* sem = sem_open (detail::semaphoreName (name).c_str(), 0);
+    if (sem == SEM_FAILED)
+        return nullptr;
+    ring->semaphore = sem;
+    #endif
+    return ring;
+#endif
+}
+
+juce::uint64 SharedMidiRing::now() noexcept
+{
+#if JUCE_WINDOWS
+    return (juce::uint64) (juce::Time::getMillisecondCounterHiRes() * 1.0e6);
+#else
+    timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (juce::uint64) ts.tv_sec * 1000000000ull + (juce::uint64) ts.tv_nsec;
+#endif
+}
+
+bool SharedMidiRing::write (const juce::uint8* bytes, int size, juce::uint64 timestamp) noexcept
+{
+    const auto total = recordSize (size);
+    if (size <= 0 || total > (juce::uint64) capacity / 2)
+        return false;
+
+    auto position = header->writePosition.load (std::memory_order_relaxed);
+    const auto used = position - header->readPosition.load (std::memory_order_acquire);
+    auto index = position & (capacity - 1);
+    const auto toEnd = capacity - index;
+    const auto needed = total + (toEnd < total ? toEnd : 0);
+
+    if (capacity - used < needed)
+        return false;
+
+    if (toEnd < total) {
+        reinterpret_cast<Record*> (data + index)->size = wrapSize;
+        position += toEnd;
+        index = 0;
+    }
+
+    auto* record = reinterpret_cast<Record*> (data + index);
+    record->size = (juce::uint32) size;
+    record->reserved = 0;
+    record->timestamp = timestamp;
+    std::memcpy (data + index + sizeof (Record), bytes, (size_t) size);
+
+    // Sequentially consistent so the reader can't miss both the data and the wake up.
+    header->writePosition.store (position + total);
+    wakeReader();
+    return true;
+}
+
+void SharedMidiRing::block (int timeoutMicros) noexcept
+{
+#if JUCE_MAC
+    // poll() only takes milliseconds, sleep out anything shorter.
+    if (timeoutMicros < 1000) {
+        usleep ((useconds_t) juce::jmax (0, timeoutMicros));
+        return;
+    }
+    pollfd wake { wakePipe, POLLIN, 0 };
+    poll (&wake, 1, timeoutMicros / 1000);
+#elif ! JUCE_WINDOWS
+    timespec ts;
+    clock_gettime (CLOCK_REALTIME, &ts);
+    const auto nanos = (juce::int64) ts.tv_nsec + (juce::int64) timeoutMicros * 1000;
+    ts.tv_sec += (time_t) (nanos / 1000000000);
+    ts.tv_nsec = (long) (nanos % 1000000000);
+    sem_timedwait (static_cast<sem_t*> (semaphore), &ts);
+#else
+    juce::ignoreUnused (timeoutMicros);
+#endif
+}
+
+void SharedMidiRing::drainWakeUps() noexcept
+{
+#if JUCE_MAC
+    // Swallow extra wake ups so the next wait actually blocks.
+    char bytes[64];
+    while (read (wakePipe, bytes, sizeof (bytes)) > 0) {
+    }
+#elif ! JUCE_WINDOWS
+    // Swallow extra posts so the next wait actually blocks.
+    while (sem_trywait (static_cast<sem_t*> (semaphore)) == 0) {
+    }
+#endif
+}
+
+void SharedMidiRing::wakeReader() noexcept
+{
+#if JUCE_MAC
+    // A full pipe already has a wake up waiting, so a failed write is fine.
+    if (header->readerWaiting.load() != 0) {
+        const char wake = 1;
+        juce::ignoreUnused (write (wakePipe, &wake, 1));
+    }
+#elif ! JUCE_WINDOWS
+    if (header->readerWaiting.load() != 0)
+        sem_post (static_cast<sem_t*> (semaphore));
+#endif
+}
+
+} // namespace vmc
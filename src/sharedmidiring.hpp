@@ -0,0 +1,191 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+/** A single producer, single consumer MIDI ring in named POSIX shared memory.
+
+    VMC creates the ring and its sender thread drains it, a process running on
+    the same machine opens it by name and writes events. Events carry a due
+    time on the monotonic clock in nanoseconds, see now(), or 0 to go out as
+    soon as possible. Only one process may write at a time.
+
+    The memory starts with a Header followed by `capacity` bytes of records.
+    Each record is a Record header followed by the MIDI bytes, padded to 16
+    bytes. A record with the wrap size tells the reader to continue at the
+    start of the buffer. Positions are free running byte counts.
+
+    The reader doesn't trust the writer: a record that is empty or runs past
+    the end of the buffer, or a write position more than the capacity ahead,
+    drops everything written so far and counts a resync.
+
+    Writers wake a waiting reader with a named semaphore. macOS can't wait on
+    one with a timeout, there a named pipe next to the ring in /tmp is used.
+
+    Not available on Windows, create() and open() return nullptr there.
+*/
+class SharedMidiRing final {
+public:
+    static constexpr const char* defaultName = "/vmc-midi";
+    static constexpr juce::uint32 magic = 0x564d4352; // 'VMCR'
+    static constexpr juce::uint32 version = 1;
+    static constexpr juce::uint32 wrapSize = 0xffffffff;
+
+    struct Header {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 capacity;
+        juce::uint32 reserved;
+        alignas (64) std::atomic<juce::uint64> writePosition;
+        alignas (64) std::atomic<juce::uint64> readPosition;
+        std::atomic<juce::uint32> readerWaiting;
+    };
+
+    struct Record {
+        juce::uint32 size;
+        juce::uint32 reserved;
+        juce::uint64 timestamp;
+    };
+
+    ~SharedMidiRing();
+
+    /** Creates the ring, replacing any stale one with the same name. The
+        capacity is rounded up to a power of two.
+    */
+    static std::unique_ptr<SharedMidiRing> create (const juce::String& name = defaultName,
+                                                   int capacity = 1 << 16);
+
+    /** Opens an existing ring for writing. */
+    static std::unique_ptr<SharedMidiRing> open (const juce::String& name = defaultName);
+
+    /** Returns the current monotonic time in nanoseconds. */
+    static juce::uint64 now() noexcept;
+
+    /** Returns the name of the ring. */
+    const juce::String& getName() const noexcept { return name; }
+
+    //==========================================================================
+    /** Writes an event. Returns false if there isn't room. Producer only. */
+    bool write (const juce::uint8* data, int size, juce::uint64 timestamp = 0) noexcept;
+
+    //==========================================================================
+    /** Passes each due event to the callback in place, then frees it.
+        Consumer only.
+
+        @param callback  called with (const uint8* data, int size, uint64 timestamp)
+        @param time      events due after this time are left in the ring
+        @returns the due time of the first event left in the ring, or 0
+    */
+    template <typename Callback>
+    juce::uint64 read (Callback&& callback, juce::uint64 time) noexcept
+    {
+        // The capacity in the header could be changed by the writer, use the one checked when mapping.
+        const auto mask = (juce::uint64) capacity - 1;
+        auto position = header->readPosition.load (std::memory_order_relaxed);
+        const auto end = header->writePosition.load (std::memory_order_acquire);
+        lastSeenEnd = end;
+
+        if (end < position || end - position > capacity) {
+            resync (end);
+            return 0;
+        }
+
+        while (position < end) {
+            const auto index = position & mask;
+            if (capacity - index < sizeof (Record)) {
+                resync (end);
+                return 0;
+            }
+
+            // Copied once, so the writer can't change it between the checks and its use.
+            Record record;
+            std::memcpy (&record, data + index, sizeof (record));
+
+            if (record.size == wrapSize) {
+                position += capacity - index;
+            } else {
+                if (record.size == 0 || sizeof (Record) + record.size > capacity - index) {
+                    resync (end);
+                    return 0;
+                }
+
+                if (record.timestamp > time) {
+                    header->readPosition.store (position, std::memory_order_release);
+                    return record.timestamp;
+                }
+
+                callback (data + index + sizeof (Record), (int) record.size, record.timestamp);
+                position += recordSize ((int) record.size);
+            }
+
+            header->readPosition.store (position, std::memory_order_release);
+        }
+
+        return 0;
+    }
+
+    /** Blocks until a writer signals or the timeout in microseconds passes.
+        Doesn't block if something was written since the last read() or if
+        isReady() returns true. Both are checked after announcing the wait so
+        a wakeReader() from another source isn't missed. Consumer only.
+    */
+    template <typename Predicate>
+    void waitForData (int timeoutMicros, Predicate&& isReady) noexcept
+    {
+        header->readerWaiting.store (1);
+        if (! hasNewData() && ! isReady())
+            block (timeoutMicros);
+        header->readerWaiting.store (0);
+        drainWakeUps();
+    }
+
+    /** Wakes the reader if it is waiting. */
+    void wakeReader() noexcept;
+
+    /** Returns how often bad records made the reader drop what was written. */
+    juce::int64 getNumResyncs() const noexcept { return numResyncs.load(); }
+
+    /** Returns true if there is something to read. */
+    bool hasData() const noexcept
+    {
+        return header->readPosition.load (std::memory_order_acquire)
+               != header->writePosition.load (std::memory_order_acquire);
+    }
+
+private:
+    SharedMidiRing() = default;
+
+    juce::String name;
+    bool owner = false;
+    size_t mappedSize = 0;
+    juce::uint32 capacity = 0;
+    std::atomic<juce::int64> numResyncs { 0 };
+    void* semaphore = nullptr;
+    int wakePipe = -1;
+    juce::uint64 lastSeenEnd = 0;
+    Header* header = nullptr;
+    juce::uint8* data = nullptr;
+
+    bool hasNewData() const noexcept { return header->writePosition.load() != lastSeenEnd; }
+    void block (int timeoutMicros) noexcept;
+    void drainWakeUps() noexcept;
+
+    void resync (juce::uint64 end) noexcept
+    {
+        ++numResyncs;
+        header->readPosition.store (end, std::memory_order_release);
+    }
+
+    static juce::uint64 recordSize (int size) noexcept
+    {
+        return sizeof (Record) + (((juce::uint64) size + 15) & ~(juce::uint64) 15);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMidiRing)
+};
+
+} // namespace vmc
@@ -0,0 +1,167 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stallwatchdog.hpp"
+#include "controller.hpp"
+#include "midisender.hpp"
+#include "tracing.hpp"
+
+namespace vmc {
+
+juce::String StallWatchdog::Stall::toString() const
+{
+    juce::String text;
+    text << time.toISO8601 (true) << " stalled " << juce::String (duration, 1) << " ms in "
+         << (handler.isNotEmpty() ? handler : juce::String ("an untraced handler")) << ", "
+         << delayedMidi << " MIDI messages delayed, " << sentMeanwhile << " sent by other threads";
+    return text;
+}
+
+StallWatchdog::StallWatchdog (MidiSender& s)
+    : juce::Thread ("VMC Stall Watchdog"),
+      sender (s)
+{
+}
+
+StallWatchdog::~StallWatchdog()
+{
+    stop();
+}
+
+juce::File StallWatchdog::getDefaultLogFile()
+{
+    return Controller::getUserDataPath().getChildFile ("stalls.log");
+}
+
+bool StallWatchdog::start (int thresholdMs, const juce::File& file)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    stop();
+
+    auto stream = std::make_unique<juce::FileOutputStream> (file);
+    if (! stream->openedOk())
+        return false;
+
+    {
+        const juce::ScopedLock sl (lock);
+        logFile = file;
+        lastStall = {};
+    }
+
+    log = std::move (stream);
+    *log << juce::Time::getCurrentTime().toISO8601 (true) << " watching for stalls over "
+         << thresholdMs << " ms\n";
+    log->flush();
+
+    threshold = juce::jmax (1, thresholdMs);
+    numStalls = 0;
+    longestStall = 0.0;
+    lastBeat = juce::Time::getMillisecondCounterHiRes();
+
+    TraceRecorder::setTrackingHandlers (true);
+    startTimer (heartbeatInterval);
+    return startThread (juce::Thread::Priority::high);
+}
+
+void StallWatchdog::stop()
+{
+    if (! isTimerRunning())
+        return;
+
+    stopTimer();
+    stopThread (1000);
+    TraceRecorder::setTrackingHandlers (false);
+    log.reset();
+}
+
+juce::File StallWatchdog::getLogFile() const
+{
+    const juce::ScopedLock sl (lock);
+    return logFile;
+}
+
+StallWatchdog::Stall StallWatchdog::getLastStall() const
+{
+    const juce::ScopedLock sl (lock);
+    return lastStall;
+}
+
+juce::String StallWatchdog::getSummary() const
+{
+    juce::String text;
+    text << (isRunning() ? "watching" : "not watching") << ", threshold " << getThreshold() << " ms, "
+         << getNumStalls() << " stalls, longest " << juce::String (getLongestStall(), 1) << " ms";
+    return text;
+}
+
+void StallWatchdog::report (const Stall& stall)
+{
+    ++numStalls;
+    if (stall.duration > longestStall.load())
+        longestStall = stall.duration;
+
+    {
+        const juce::ScopedLock sl (lock);
+        lastStall = stall;
+    }
+
+    if (log != nullptr) {
+        *log << stall.toString() << "\n";
+        log->flush();
+    }
+}
+
+void StallWatchdog::timerCallback()
+{
+    lastBeat = juce::Time::getMillisecondCounterHiRes();
+}
+
+void StallWatchdog::run()
+{
+    enum State {
+        idle,
+        stalled,
+        catchingUp
+    };
+
+    State state = idle;
+    Stall stall;
+    double stallStart = 0.0, catchUpEnd = 0.0;
+    juce::int64 queuedAtStart = 0, sentAtStart = 0;
+
+    while (! threadShouldExit()) {
+        wait (heartbeatInterval / 2);
+
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        const auto beat = lastBeat.load();
+        const bool overdue = now - beat > (double) (heartbeatInterval + threshold.load());
+
+        if (state == idle && overdue) {
+            // Note what was running while the stall is still in progress.
+            stall = {};
+            stall.time = juce::Time::getCurrentTime() - juce::RelativeTime::milliseconds ((juce::int64) (now - beat));
+            stall.handler = TraceRecorder::getCurrentHandler();
+            stallStart = beat;
+            queuedAtStart = sender.getNumFromMessageThread();
+            sentAtStart = sender.getNumSent();
+            state = stalled;
+        } else if (state == stalled) {
+            if (stall.handler.isEmpty())
+                stall.handler = TraceRecorder::getCurrentHandler();
+
+            if (beat > stallStart) {
+                stall.duration = juce::jmax (0.0, beat - stallStart - (double) heartbeatInterval);
+                stall.sentMeanwhile = sender.getNumSent() - sentAtStart;
+                catchUpEnd = now + (double) catchUpTime;
+                state = catchingUp;
+            }
+        } else if (state == catchingUp && (now >= catchUpEnd || overdue)) {
+            // Gestures queued during the stall have been handled by now.
+            stall.delayedMidi = sender.getNumFromMessageThread() - queuedAtStart;
+            report (stall);
+            state = idle;
+        }
+    }
+}
+
+} // namespace vmc
@@ -0,0 +1,87 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+class MidiSender;
+
+/** Watches the message thread for stalls and logs what they cost the MIDI path.
+
+    A timer on the message thread beats every heartbeatInterval. The watchdog
+    thread checks the last beat, and when it is overdue by more than the
+    threshold it notes the innermost trace span running on the message thread.
+    Once beats resume it waits catchUpTime for queued gestures to be handled,
+    then appends a line to the log with the stall's duration, the handler and
+    how many MIDI messages the message thread queued late.
+*/
+class StallWatchdog final : private juce::Thread,
+                            private juce::Timer {
+public:
+    struct Stall {
+        /** When the message thread stopped responding. */
+        juce::Time time;
+        /** How long it didn't respond, in milliseconds. */
+        double duration = 0.0;
+        /** The trace span that was running, empty if none was. */
+        juce::String handler;
+        /** Messages queued from the message thread during the stall and catch up. */
+        juce::int64 delayedMidi = 0;
+        /** Messages other threads sent meanwhile, which weren't held up. */
+        juce::int64 sentMeanwhile = 0;
+
+        juce::String toString() const;
+    };
+
+    static constexpr int heartbeatInterval = 20;
+    static constexpr int catchUpTime = 100;
+    static constexpr int defaultThreshold = 100;
+
+    explicit StallWatchdog (MidiSender& sender);
+    ~StallWatchdog() override;
+
+    /** Starts watching, appending stalls longer than the threshold in
+        milliseconds to the log file. Call on the message thread.
+    */
+    bool start (int thresholdMs, const juce::File& logFile);
+    /** Stops watching. Call on the message thread. */
+    void stop();
+    bool isRunning() const noexcept { return isThreadRunning(); }
+
+    int getThreshold() const noexcept { return threshold.load(); }
+    juce::File getLogFile() const;
+
+    /** Returns the number of stalls and the longest in milliseconds since start. */
+    int getNumStalls() const noexcept { return numStalls.load(); }
+    double getLongestStall() const noexcept { return longestStall.load(); }
+    /** Returns the most recent stall, if getNumStalls() isn't zero. */
+    Stall getLastStall() const;
+
+    /** Returns a one line summary of the counters above. */
+    juce::String getSummary() const;
+
+    /** Returns stalls.log in the user data folder. */
+    static juce::File getDefaultLogFile();
+
+private:
+    MidiSender& sender;
+    juce::File logFile;
+    std::unique_ptr<juce::FileOutputStream> log;
+    std::atomic<double> lastBeat { 0.0 };
+    std::atomic<int> threshold { defaultThreshold };
+    std::atomic<int> numStalls { 0 };
+    std::atomic<double> longestStall { 0.0 };
+    Stall lastStall;
+    juce::CriticalSection lock;
+
+    void report (const Stall& stall);
+    void timerCallback() override;
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (StallWatchdog)
+};
+
+} // namespace vmc
@@ -0,0 +1,260 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stressgenerator.hpp"
+#include "midisender.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int stressLowestNote = 36;
+static constexpr int stressHighestNote = 96;
+
+static juce::int64 ticksToMicros (juce::int64 ticks) noexcept
+{
+    return (juce::int64) (juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6);
+}
+} // namespace detail
+
+juce::String StressGenerator::Stats::toString() const
+{
+    juce::String text;
+    text << (running ? "running" : "stopped") << ": " << sent << " sent in "
+         << juce::String (elapsed, 1) << " s, " << juce::String (achievedRate, 1) << "/s of "
+         << juce::String (targetRate, 1) << "/s, " << queued << " queued, " << dropped << " dropped\n"
+         << "enqueue p50 " << enqueueP50 << " us, p99 " << enqueueP99 << " us, max " << enqueueMax << " us\n"
+         << "send call p50 " << sendCallP50 << " us, p99 " << sendCallP99 << " us, max " << sendCallMax << " us\n"
+         << "late max " << maxLateness << " us, " << resyncs << " resyncs, backlog " << backlog
+         << " (max " << maxBacklog << ")";
+    return text;
+}
+
+StressGenerator::StressGenerator (MidiSender& s)
+    : juce::Thread ("VMC Stress Generator"),
+      sender (s)
+{
+}
+
+StressGenerator::~StressGenerator()
+{
+    stop();
+}
+
+bool StressGenerator::parseMode (const juce::String& name, Mode& mode)
+{
+    const auto lower = name.toLowerCase();
+    if (lower == "cc")
+        mode = ccSweep;
+    else if (lower == "notes")
+        mode = noteStorm;
+    else if (lower == "mixed")
+        mode = mixed;
+    else
+        return false;
+    return true;
+}
+
+const char* StressGenerator::getModeName (Mode mode) noexcept
+{
+    if (mode == noteStorm)
+        return "notes";
+    if (mode == mixed)
+        return "mixed";
+    return "cc";
+}
+
+bool StressGenerator::start (const Options& newOptions)
+{
+    stop();
+
+    auto opts = newOptions;
+    opts.rate = juce::jlimit (1.0, 10000.0, opts.rate);
+    opts.numControllers = juce::jlimit (1, 128, opts.numControllers);
+    opts.firstController = juce::jlimit (0, 127, opts.firstController);
+    opts.polyphony = juce::jlimit (1, detail::stressHighestNote - detail::stressLowestNote + 1, opts.polyphony);
+    opts.sysexSize = juce::jlimit (3, 4096, opts.sysexSize);
+    opts.sysexInterval = juce::jmax (2, opts.sysexInterval);
+    opts.channel = juce::jlimit (1, 16, opts.channel);
+    opts.duration = juce::jmax (0.0, opts.duration);
+
+    {
+        const juce::ScopedLock sl (optionsLock);
+        options = opts;
+    }
+
+    // Non-commercial manufacturer ID, then a counting payload.
+    juce::HeapBlock<juce::uint8> payload ((size_t) opts.sysexSize - 2);
+    payload[0] = 0x7d;
+    for (int i = 1; i < opts.sysexSize - 2; ++i)
+        payload[i] = (juce::uint8) (i & 0x7f);
+    sysex = juce::MidiMessage::createSysExMessage (payload.get(), opts.sysexSize - 2);
+
+    enqueue.reset();
+    sender.getSendCallTimes().reset();
+    sentAtStart = sender.getNumSent();
+    numQueued = 0;
+    numDropped = 0;
+    numResyncs = 0;
+    maxLateness = 0;
+    maxBacklog = 0;
+    step = 0;
+    numHeld = 0;
+    startTime = juce::Time::getMillisecondCounterHiRes();
+    endTime = 0.0;
+
+    return startThread (juce::Thread::Priority::high);
+}
+
+void StressGenerator::stop()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (2000);
+}
+
+StressGenerator::Options StressGenerator::getOptions() const
+{
+    const juce::ScopedLock sl (optionsLock);
+    return options;
+}
+
+StressGenerator::Stats StressGenerator::getStats() const
+{
+    Stats stats;
+    stats.running = isThreadRunning();
+    stats.targetRate = getOptions().rate;
+
+    const auto start = startTime.load();
+    auto end = endTime.load();
+    if (end <= 0.0)
+        end = juce::Time::getMillisecondCounterHiRes();
+    stats.elapsed = start > 0.0 ? (end - start) * 0.001 : 0.0;
+
+    // Counted at the sender, which other sources may share for the run.
+    stats.sent = sender.getNumSent() - sentAtStart.load();
+    stats.queued = numQueued.load();
+    stats.dropped = numDropped.load();
+    stats.resyncs = numResyncs.load();
+    stats.achievedRate = stats.elapsed > 0.0 ? (double) stats.sent / stats.elapsed : 0.0;
+    stats.enqueueP50 = enqueue.getPercentile (50.0);
+    stats.enqueueP99 = enqueue.getPercentile (99.0);
+    stats.enqueueMax = enqueue.getMax();
+    const auto& sendCall = sender.getSendCallTimes();
+    stats.sendCallP50 = sendCall.getPercentile (50.0);
+    stats.sendCallP99 = sendCall.getPercentile (99.0);
+    stats.sendCallMax = sendCall.getMax();
+    stats.maxLateness = maxLateness.load();
+    stats.backlog = sender.getNumPending();
+    stats.maxBacklog = maxBacklog.load();
+    return stats;
+}
+
+juce::MidiMessage StressGenerator::nextMessage (const Options& opts, juce::int64 index)
+{
+    if (opts.mode == noteStorm)
+        return nextNote (opts);
+
+    if (opts.mode == mixed) {
+        if (index % opts.sysexInterval == opts.sysexInterval - 1)
+            return sysex;
+        if (index % 2 == 1)
+            return nextNote (opts);
+    }
+
+    // Each controller sweeps up and down in turn.
+    const int controller = (opts.firstController + step % opts.numControllers) & 0x7f;
+    const int position = (step / opts.numControllers) % 254;
+    ++step;
+    return juce::MidiMessage::controllerEvent (opts.channel, controller, position < 127 ? position : 254 - position);
+}
+
+juce::MidiMessage StressGenerator::nextNote (const Options& opts)
+{
+    if (numHeld >= opts.polyphony || (numHeld > 0 && random.nextBool())) {
+        const int note = heldNotes[0];
+        std::copy (heldNotes.begin() + 1, heldNotes.begin() + numHeld, heldNotes.begin());
+        --numHeld;
+        return juce::MidiMessage::noteOff (opts.channel, note);
+    }
+
+    int note = 0;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        note = detail::stressLowestNote + random.nextInt (detail::stressHighestNote - detail::stressLowestNote + 1);
+        if (std::find (heldNotes.begin(), heldNotes.begin() + numHeld, note) == heldNotes.begin() + numHeld)
+            break;
+    }
+
+    heldNotes[(size_t) numHeld++] = note;
+    return juce::MidiMessage::noteOn (opts.channel, note, (juce::uint8) (1 + random.nextInt (127)));
+}
+
+bool StressGenerator::sendMessage (const juce::MidiMessage& message)
+{
+    const auto before = juce::Time::getHighResolutionTicks();
+    const bool added = sender.add (message);
+    enqueue.record (detail::ticksToMicros (juce::Time::getHighResolutionTicks() - before));
+
+    if (added)
+        ++numQueued;
+    else
+        ++numDropped;
+
+    const int backlog = sender.getNumPending();
+    if (backlog > maxBacklog.load (std::memory_order_relaxed))
+        maxBacklog.store (backlog, std::memory_order_relaxed);
+    return added;
+}
+
+void StressGenerator::releaseNotes (const Options& opts)
+{
+    for (int i = 0; i < numHeld; ++i)
+        sendMessage (juce::MidiMessage::noteOff (opts.channel, heldNotes[(size_t) i]));
+    numHeld = 0;
+}
+
+void StressGenerator::run()
+{
+    const auto opts = getOptions();
+    const auto ticksPerSecond = (double) juce::Time::getHighResolutionTicksPerSecond();
+    const auto period = ticksPerSecond / opts.rate;
+    const auto resyncTicks = (juce::int64) (resyncTime * ticksPerSecond);
+
+    auto origin = juce::Time::getHighResolutionTicks();
+    const auto endTicks = opts.duration > 0.0 ? origin + (juce::int64) (opts.duration * ticksPerSecond) : 0;
+    juce::int64 index = 0;
+
+    while (! threadShouldExit()) {
+        // Due times are offsets from the origin, so errors never accumulate.
+        const auto due = origin + (juce::int64) ((double) index * period);
+        auto now = juce::Time::getHighResolutionTicks();
+        if (endTicks > 0 && now >= endTicks)
+            break;
+
+        if (due > now) {
+            // Sleep most of the way, then yield until due for precision.
+            const auto millis = juce::Time::highResolutionTicksToSeconds (due - now) * 1000.0;
+            if (millis > 2.0)
+                wait (millis - 1.5);
+            while ((now = juce::Time::getHighResolutionTicks()) < due && ! threadShouldExit())
+                juce::Thread::yield();
+        }
+
+        const auto late = now - due;
+        if (late > resyncTicks) {
+            // Too far behind to catch up with a burst, start the schedule again from now.
+            origin = now - (juce::int64) ((double) index * period);
+            ++numResyncs;
+        } else {
+            const auto lateMicros = detail::ticksToMicros (juce::jmax ((juce::int64) 0, late));
+            if (lateMicros > maxLateness.load (std::memory_order_relaxed))
+                maxLateness.store (lateMicros, std::memory_order_relaxed);
+        }
+
+        sendMessage (nextMessage (opts, index));
+        ++index;
+    }
+
+    releaseNotes (opts);
+    endTime = juce::Time::getMillisecondCounterHiRes();
+}
+
+} // namespace vmc
@@ -0,0 +1,114 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include "latencytracer.hpp"
+
+namespace vmc {
+
+class MidiSender;
+
+/** Sends synthetic MIDI at a steady rate to qualify synths and interfaces.
+
+    Messages are due at fixed offsets from the start on the high resolution
+    clock, so timing errors don't add up. The thread sleeps until just before
+    each message is due, then yields until it is. If it falls more than
+    resyncTime behind, it skips ahead instead of sending a burst.
+*/
+class StressGenerator final : private juce::Thread {
+public:
+    enum Mode {
+        ccSweep = 0,
+        noteStorm,
+        mixed
+    };
+
+    struct Options {
+        Mode mode = ccSweep;
+        /** Messages per second, 1 to 10000. */
+        double rate = 1000.0;
+        /** Controllers swept in CC mode, from firstController up. */
+        int numControllers = 8;
+        int firstController = 20;
+        /** Notes held at once in note storms, up to 61. */
+        int polyphony = 8;
+        /** Size of SysEx messages in mixed mode, including F0 and F7. */
+        int sysexSize = 64;
+        /** Mixed mode sends one SysEx every this many messages. */
+        int sysexInterval = 16;
+        int channel = 1;
+        /** Stops after this many seconds, or runs until stopped if zero. */
+        double duration = 0.0;
+    };
+
+    struct Stats {
+        bool running = false;
+        double targetRate = 0.0;
+        /** Messages per second the sender actually sent. */
+        double achievedRate = 0.0;
+        double elapsed = 0.0;
+        /** Messages sent by the sender since the start, and queued by the generator. */
+        juce::int64 sent = 0;
+        juce::int64 queued = 0;
+        juce::int64 dropped = 0;
+        juce::int64 resyncs = 0;
+        /** Time spent queueing each message, in microseconds. */
+        juce::int64 enqueueP50 = 0, enqueueP99 = 0, enqueueMax = 0;
+        /** Time the sender spent in each send to the output, in microseconds. */
+        juce::int64 sendCallP50 = 0, sendCallP99 = 0, sendCallMax = 0;
+        /** Worst time a message went out after it was due, in microseconds. */
+        juce::int64 maxLateness = 0;
+        int backlog = 0;
+        int maxBacklog = 0;
+
+        juce::String toString() const;
+    };
+
+    static constexpr double resyncTime = 0.05;
+
+    explicit StressGenerator (MidiSender& sender);
+    ~StressGenerator() override;
+
+    /** Starts generating, stopping any run already going. */
+    bool start (const Options& options);
+    /** Stops generating and releases held notes. */
+    void stop();
+    bool isRunning() const noexcept { return isThreadRunning(); }
+
+    /** Returns the options of the current or last run. */
+    Options getOptions() const;
+    /** Returns live statistics of the current or last run. */
+    Stats getStats() const;
+
+    /** Parses a mode name: cc, notes or mixed. Returns false if unknown. */
+    static bool parseMode (const juce::String& name, Mode& mode);
+    static const char* getModeName (Mode mode) noexcept;
+
+private:
+    MidiSender& sender;
+    Options options;
+    juce::CriticalSection optionsLock;
+    LatencyHistogram enqueue;
+    std::atomic<juce::int64> sentAtStart { 0 }, numQueued { 0 }, numDropped { 0 }, numResyncs { 0 }, maxLateness { 0 };
+    std::atomic<int> maxBacklog { 0 };
+    std::atomic<double> startTime { 0.0 }, endTime { 0.0 };
+
+    // Generator state, used only on the thread.
+    int step = 0;
+    std::array<int, 128> heldNotes {};
+    int numHeld = 0;
+    juce::Random random;
+    juce::MidiMessage sysex;
+
+    juce::MidiMessage nextMessage (const Options& opts, juce::int64 index);
+    juce::MidiMessage nextNote (const Options& opts);
+    bool sendMessage (const juce::MidiMessage& message);
+    void releaseNotes (const Options& opts);
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (StressGenerator)
+};
+
+} // namespace vmc
@@ -0,0 +1,138 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stressgeneratorcomponent.hpp"
+#include "controller.hpp"
+#include "device.hpp"
+#include "stressgenerator.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int stressLineHeight = 16;
+
+inline static void styleStressLabel (juce::Label& label, const juce::String& text)
+{
+    label.setText (text, juce::dontSendNotification);
+    label.setColour (juce::Label::textColourId, juce::Colours::white.withAlpha (0.8f));
+    label.setFont (juce::Font (juce::FontOptions (12.0f)));
+}
+
+inline static void styleStressSlider (juce::Slider& slider, double min, double max, double interval, double value)
+{
+    slider.setSliderStyle (juce::Slider::IncDecButtons);
+    slider.setTextBoxStyle (juce::Slider::TextBoxLeft, false, 60, 24);
+    slider.setRange (min, max, interval);
+    slider.setValue (value, juce::dontSendNotification);
+}
+} // namespace detail
+
+StressGeneratorComponent::StressGeneratorComponent (Controller& c)
+    : controller (c)
+{
+    const auto options = controller.getStressGenerator().getOptions();
+
+    addAndMakeVisible (mode);
+    mode.addItem ("CC sweep", StressGenerator::ccSweep + 1);
+    mode.addItem ("Note storm", StressGenerator::noteStorm + 1);
+    mode.addItem ("Mixed with SysEx", StressGenerator::mixed + 1);
+    mode.setSelectedId (options.mode + 1, juce::dontSendNotification);
+    mode.onChange = [this]() { updateCountLabel(); };
+
+    addAndMakeVisible (rateLabel);
+    detail::styleStressLabel (rateLabel, "Messages/s");
+    addAndMakeVisible (rate);
+    detail::styleStressSlider (rate, 1.0, 10000.0, 1.0, options.rate);
+
+    addAndMakeVisible (countLabel);
+    addAndMakeVisible (count);
+    detail::styleStressSlider (count, 1.0, 128.0, 1.0, options.mode == StressGenerator::noteStorm ? options.polyphony : options.numControllers);
+    updateCountLabel();
+
+    addAndMakeVisible (durationLabel);
+    detail::styleStressLabel (durationLabel, "Seconds (0 = until stopped)");
+    addAndMakeVisible (duration);
+    detail::styleStressSlider (duration, 0.0, 3600.0, 1.0, options.duration);
+
+    addAndMakeVisible (startButton);
+    startButton.onClick = [this]() { toggleRunning(); };
+
+    timerCallback();
+    startTimerHz (4);
+    setSize (480, 104 + 4 * detail::stressLineHeight);
+}
+
+StressGeneratorComponent::~StressGeneratorComponent()
+{
+    stopTimer();
+}
+
+void StressGeneratorComponent::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colour::fromRGB (45, 48, 52));
+
+    g.setColour (juce::Colours::white.withAlpha (0.9f));
+    g.setFont (juce::Font (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain)));
+
+    auto r = getLocalBounds().reduced (8).withTrimmedTop (96);
+    for (const auto& line : lines)
+        g.drawText (line, r.removeFromTop (detail::stressLineHeight), juce::Justification::centredLeft, false);
+}
+
+void StressGeneratorComponent::resized()
+{
+    auto r = getLocalBounds().reduced (8);
+
+    auto row = r.removeFromTop (24);
+    startButton.setBounds (row.removeFromRight (80));
+    row.removeFromRight (6);
+    mode.setBounds (row);
+    r.removeFromTop (6);
+
+    row = r.removeFromTop (24);
+    rateLabel.setBounds (row.removeFromLeft (80));
+    rate.setBounds (row.removeFromLeft (150));
+    row.removeFromLeft (10);
+    countLabel.setBounds (row.removeFromLeft (80));
+    count.setBounds (row.removeFromLeft (120));
+    r.removeFromTop (6);
+
+    row = r.removeFromTop (24);
+    durationLabel.setBounds (row.removeFromLeft (160));
+    duration.setBounds (row.removeFromLeft (150));
+}
+
+void StressGeneratorComponent::updateCountLabel()
+{
+    detail::styleStressLabel (countLabel, mode.getSelectedId() - 1 == StressGenerator::ccSweep ? "Controllers" : "Polyphony");
+}
+
+void StressGeneratorComponent::toggleRunning()
+{
+    auto& generator = controller.getStressGenerator();
+    if (generator.isRunning()) {
+        generator.stop();
+        timerCallback();
+        return;
+    }
+
+    StressGenerator::Options options;
+    options.mode = (StressGenerator::Mode) juce::jlimit (0, 2, mode.getSelectedId() - 1);
+    options.rate = rate.getValue();
+    options.numControllers = juce::roundToInt (count.getValue());
+    options.polyphony = juce::roundToInt (count.getValue());
+    options.duration = duration.getValue();
+    options.channel = juce::jlimit (1, 16, controller.device().midiChannel());
+    generator.start (options);
+    timerCallback();
+}
+
+void StressGeneratorComponent::timerCallback()
+{
+    const auto stats = controller.getStressGenerator().getStats();
+    lines = juce::StringArray::fromLines (stats.toString());
+    startButton.setButtonText (stats.running ? "Stop" : "Start");
+    mode.setEnabled (! stats.running);
+    repaint();
+}
+
+} // namespace vmc
@@ -0,0 +1,38 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+#include <juce_gui_basics/juce_gui_basics.h>
+
+namespace vmc {
+
+class Controller;
+
+/** Starts and stops the stress generator and shows its stats while it runs. */
+class StressGeneratorComponent : public juce::Component,
+                                 private juce::Timer {
+public:
+    StressGeneratorComponent (Controller& controller);
+    ~StressGeneratorComponent() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    Controller& controller;
+    juce::ComboBox mode;
+    juce::Slider rate, count, duration;
+    juce::Label rateLabel, countLabel, durationLabel;
+    juce::TextButton startButton;
+    juce::StringArray lines;
+
+    void toggleRunning();
+    void updateCountLabel();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StressGeneratorComponent)
+};
+
+} // namespace vmc
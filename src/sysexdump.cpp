@@ -0,0 +1,325 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "sysexdump.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr uint8 dumpSignature[] = { SysExDump::manufacturerID, 'V', 'M', 'C', SysExDump::dumpCommand };
+static constexpr int dumpSignatureSize = (int) sizeof (dumpSignature);
+
+static void writeNumber (uint8* dest, int& pos, int value, int numBytes)
+{
+    for (int i = numBytes; --i >= 0;)
+        dest[pos++] = (uint8) ((value >> (7 * i)) & 0x7f);
+}
+
+static int readNumber (const uint8* src, int numBytes)
+{
+    int value = 0;
+    for (int i = 0; i < numBytes; ++i)
+        value = (value << 7) | (src[i] & 0x7f);
+    return value;
+}
+} // namespace detail
+
+//==============================================================================
+juce::Array<juce::MidiMessage> SysExDump::createPackets (const juce::ValueTree& data, int chunkSize)
+{
+    juce::MemoryOutputStream stream;
+    data.writeToStream (stream);
+
+    const auto* raw = static_cast<const uint8*> (stream.getData());
+    const int total = (int) stream.getDataSize();
+    chunkSize = juce::jlimit (7, 16383, chunkSize);
+    const int count = juce::jmax (1, (total + chunkSize - 1) / chunkSize);
+
+    juce::Array<juce::MidiMessage> packets;
+    packets.ensureStorageAllocated (count);
+    juce::HeapBlock<uint8> packet ((size_t) (1 + headerSize + encodedSize (chunkSize) + 2));
+
+    for (int index = 0; index < count; ++index) {
+        const int offset = index * chunkSize;
+        const int size = juce::jmin (chunkSize, total - offset);
+        int pos = 0;
+
+        packet[pos++] = 0xf0;
+        for (auto byte : detail::dumpSignature)
+            packet[pos++] = byte;
+        detail::writeNumber (packet, pos, index, 3);
+        detail::writeNumber (packet, pos, count, 3);
+        detail::writeNumber (packet, pos, total, 4);
+        detail::writeNumber (packet, pos, chunkSize, 2);
+
+        uint8 checksum = 0;
+        for (int i = 0; i < size; i += 7) {
+            const int groupSize = juce::jmin (7, size - i);
+            uint8 msbs = 0;
+            for (int j = 0; j < groupSize; ++j)
+                if (raw[offset + i + j] & 0x80)
+                    msbs |= (uint8) (1 << j);
+
+            packet[pos++] = msbs;
+            checksum = (uint8) (checksum + msbs);
+            for (int j = 0; j < groupSize; ++j) {
+                const auto byte = (uint8) (raw[offset + i + j] & 0x7f);
+                packet[pos++] = byte;
+                checksum = (uint8) (checksum + byte);
+            }
+        }
+
+        packet[pos++] = (uint8) (checksum & 0x7f);
+        packet[pos++] = 0xf7;
+        packets.add (juce::MidiMessage (packet.getData(), pos));
+    }
+
+    return packets;
+}
+
+//==============================================================================
+SysExDumpReceiver::SysExDumpReceiver (int maxDumpSize)
+    : buffer ((size_t) maxDumpSize), capacity (maxDumpSize)
+{
+}
+
+void SysExDumpReceiver::handlePartialSysex (const uint8* data, int size)
+{
+    // JUCE hands over everything received so far, including the leading F0.
+    if (size > 0 && data[0] == 0xf0)
+        feed (data + 1, size - 1);
+}
+
+bool SysExDumpReceiver::handleMessage (const juce::MidiMessage& msg)
+{
+    if (! msg.isSysEx())
+        return false;
+
+    const int size = msg.getSysExDataSize();
+    if (size < seen)
+        resetPacket();
+
+    feed (msg.getSysExData(), size);
+    const bool wasDumpPacket = seen >= detail::dumpSignatureSize
+                               && std::memcmp (header, detail::dumpSignature, (size_t) detail::dumpSignatureSize) == 0;
+    finishPacket();
+    return wasDumpPacket;
+}
+
+void SysExDumpReceiver::reset() noexcept
+{
+    resetPacket();
+    expectedIndex = packetCount = totalSize = chunkSize = 0;
+}
+
+void SysExDumpReceiver::feed (const uint8* data, int size)
+{
+    for (; seen < size; ++seen)
+        process (data[seen]);
+}
+
+void SysExDumpReceiver::process (uint8 byte)
+{
+    if (ignoring)
+        return;
+
+    if (seen < SysExDump::headerSize) {
+        header[seen] = byte;
+        if (seen < detail::dumpSignatureSize && byte != detail::dumpSignature[seen])
+            ignoring = true;
+        else if (seen == SysExDump::headerSize - 1 && ! parseHeader())
+            ignoring = true;
+        return;
+    }
+
+    const int pos = seen - SysExDump::headerSize;
+    if (pos < packetEncodedSize) {
+        checksum = (uint8) (checksum + byte);
+        const int group = pos % 8;
+        if (group == 0)
+            msbs = byte;
+        else
+            buffer[writePos++] = (uint8) ((byte & 0x7f) | (((msbs >> (group - 1)) & 1) << 7));
+    } else {
+        packetValid = pos == packetEncodedSize && (checksum & 0x7f) == byte;
+    }
+}
+
+bool SysExDumpReceiver::parseHeader()
+{
+    const int index = detail::readNumber (header + 5, 3);
+    const int count = detail::readNumber (header + 8, 3);
+    const int total = detail::readNumber (header + 11, 4);
+    const int chunk = detail::readNumber (header + 15, 2);
+
+    if (count <= 0 || chunk <= 0 || total > capacity || index >= count) {
+        reset();
+        return false;
+    }
+
+    if (index == 0) {
+        expectedIndex = 0;
+        packetCount = count;
+        totalSize = total;
+        chunkSize = chunk;
+    } else if (index != expectedIndex || count != packetCount || total != totalSize || chunk != chunkSize) {
+        // Out of order or from a different dump, start over on the next first packet.
+        reset();
+        return false;
+    }
+
+    packetIndex = index;
+    writePos = index * chunkSize;
+    packetSize = juce::jmin (chunkSize, totalSize - writePos);
+    if (packetSize < 0) {
+        reset();
+        return false;
+    }
+
+    packetEncodedSize = SysExDump::encodedSize (packetSize);
+    return true;
+}
+
+void SysExDumpReceiver::finishPacket()
+{
+    const bool isComplete = ! ignoring && seen == SysExDump::headerSize + packetEncodedSize + 1;
+
+    if (isComplete && packetValid) {
+        if (++expectedIndex == packetCount) {
+            auto state = juce::ValueTree::readFromData (buffer.getData(), (size_t) totalSize);
+            reset();
+            if (state.isValid() && onDumpReceived)
+                onDumpReceived (state);
+            return;
+        }
+    } else if (! ignoring && seen >= SysExDump::headerSize) {
+        DBG ("[vmc] corrupt dump packet " << packetIndex << ", dump discarded");
+        reset();
+        return;
+    }
+
+    resetPacket();
+}
+
+void SysExDumpReceiver::resetPacket() noexcept
+{
+    seen = 0;
+    ignoring = false;
+    msbs = checksum = 0;
+    packetIndex = packetSize = packetEncodedSize = writePos = 0;
+    packetValid = false;
+}
+
+//==============================================================================
+namespace detail {
+class PacketArraySource final : public SysExSender::Source {
+public:
+    explicit PacketArraySource (juce::Array<juce::MidiMessage> p)
+        : packets (std::move (p))
+    {
+        for (const auto& packet : packets)
+            total += packet.getRawDataSize();
+    }
+
+    juce::int64 getTotalBytes() const override { return total; }
+
+    bool getNextMessage (juce::MidiMessage& message) override
+    {
+        if (index >= packets.size())
+            return false;
+        message = packets.getReference (index++);
+        return true;
+    }
+
+private:
+    juce::Array<juce::MidiMessage> packets;
+    juce::int64 total = 0;
+    int index = 0;
+};
+} // namespace detail
+
+SysExSender::SysExSender (SendFunction fn)
+    : juce::Thread ("VMC SysEx Sender"), sendFunction (std::move (fn))
+{
+}
+
+SysExSender::~SysExSender()
+{
+    cancel();
+}
+
+void SysExSender::setBytesPerSecond (int newBytesPerSecond) noexcept
+{
+    bytesPerSecond.store (juce::jmax (1, newBytesPerSecond));
+}
+
+void SysExSender::setPacketInterval (int milliseconds) noexcept
+{
+    packetInterval.store (juce::jmax (0, milliseconds));
+}
+
+bool SysExSender::send (juce::Array<juce::MidiMessage> packets)
+{
+    if (packets.isEmpty())
+        return false;
+    return send (std::make_unique<detail::PacketArraySource> (std::move (packets)));
+}
+
+bool SysExSender::send (std::unique_ptr<Source> newSource)
+{
+    if (isThreadRunning() || newSource == nullptr)
+        return false;
+
+    source = std::move (newSource);
+    bytesSent.store (0);
+    totalBytes.store (source->getTotalBytes());
+    startTime.store (juce::Time::getMillisecondCounterHiRes());
+    endTime.store (0.0);
+    return startThread();
+}
+
+void SysExSender::cancel()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (1000);
+}
+
+double SysExSender::getProgress() const noexcept
+{
+    const auto total = totalBytes.load();
+    return total > 0 ? juce::jlimit (0.0, 1.0, (double) bytesSent.load() / (double) total) : 0.0;
+}
+
+double SysExSender::getThroughput() const noexcept
+{
+    const auto start = startTime.load();
+    auto end = endTime.load();
+    if (end <= 0.0)
+        end = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsed = (end - start) * 0.001;
+    return elapsed > 0.0 ? (double) bytesSent.load() / elapsed : 0.0;
+}
+
+void SysExSender::run()
+{
+    juce::MidiMessage packet;
+    bool hasPacket = source->getNextMessage (packet);
+
+    while (hasPacket && ! threadShouldExit()) {
+        sendFunction (packet);
+        bytesSent += packet.getRawDataSize();
+
+        const double bytes = packet.getRawDataSize();
+        hasPacket = source->getNextMessage (packet);
+
+        if (hasPacket) {
+            const int rateDelay = juce::roundToInt (bytes * 1000.0 / bytesPerSecond.load());
+            wait (juce::jmax (1, rateDelay, packetInterval.load()));
+        }
+    }
+
+    endTime.store (juce::Time::getMillisecondCounterHiRes());
+    source.reset();
+}
+
+} // namespace vmc
@@ -0,0 +1,142 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+namespace vmc {
+
+/** Encodes device state as a stream of SysEx packets.
+
+    Every packet carries a small header followed by a 7-bit encoded chunk of the
+    device's binary ValueTree and a checksum:
+
+        F0 7D 'V' 'M' 'C' 01 <index:3> <count:3> <total:4> <chunk:2> <payload...> <sum> F7
+
+    Multi-byte numbers are sent as 7-bit groups, most significant first.
+*/
+struct SysExDump final {
+    static constexpr uint8 manufacturerID = 0x7d; // non-commercial / educational
+    static constexpr uint8 dumpCommand = 0x01;
+    static constexpr int headerSize = 17; // excluding the leading F0
+    static constexpr int defaultChunkSize = 256;
+
+    /** Returns the number of bytes needed to 7-bit encode numBytes raw bytes. */
+    static constexpr int encodedSize (int numBytes) noexcept { return numBytes + (numBytes + 6) / 7; }
+
+    /** Serialises the tree and splits it into dump packets. */
+    static juce::Array<juce::MidiMessage> createPackets (const juce::ValueTree& data,
+                                                         int chunkSize = defaultChunkSize);
+};
+
+/** Reassembles incoming dump packets into a preallocated buffer.
+
+    Bytes are decoded as they arrive, so partial SysEx data can be fed in before
+    the complete message shows up. Only meant to be called from the MIDI input thread.
+*/
+class SysExDumpReceiver final {
+public:
+    /** Creates a receiver that can accept dumps of up to capacity bytes. */
+    explicit SysExDumpReceiver (int capacity = 1024 * 1024);
+    ~SysExDumpReceiver() = default;
+
+    /** Called with the state once a full dump has been received and verified. */
+    std::function<void (juce::ValueTree)> onDumpReceived;
+
+    /** Feeds the partial data of a SysEx message that is still arriving.
+        @param data  The bytes received so far, starting with F0.
+        @param size  The number of bytes received so far.
+    */
+    void handlePartialSysex (const uint8* data, int size);
+
+    /** Handles a complete message. Returns true if it was a dump packet. */
+    bool handleMessage (const juce::MidiMessage& msg);
+
+    /** Discards any dump in progress. */
+    void reset() noexcept;
+
+private:
+    juce::HeapBlock<uint8> buffer;
+    const int capacity;
+
+    uint8 header[SysExDump::headerSize] {};
+    int seen = 0;
+    bool ignoring = false;
+    uint8 msbs = 0;
+    int packetIndex = 0, packetSize = 0, packetEncodedSize = 0;
+    int writePos = 0;
+    uint8 checksum = 0;
+    bool packetValid = false;
+
+    int expectedIndex = 0, packetCount = 0, totalSize = 0, chunkSize = 0;
+
+    void feed (const uint8* data, int size);
+    void process (uint8 byte);
+    bool parseHeader();
+    void finishPacket();
+    void resetPacket() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (SysExDumpReceiver)
+};
+
+/** Sends SysEx from a background thread at a paced rate so slower receivers
+    don't overflow.
+*/
+class SysExSender final : private juce::Thread {
+public:
+    /** Supplies the messages to send, one at a time. */
+    struct Source {
+        virtual ~Source() = default;
+        /** Returns the total number of bytes this source will produce. */
+        virtual juce::int64 getTotalBytes() const = 0;
+        /** Fetches the next message. Returns false when there are no more. */
+        virtual bool getNextMessage (juce::MidiMessage& message) = 0;
+    };
+
+    using SendFunction = std::function<void (const juce::MidiMessage&)>;
+
+    explicit SysExSender (SendFunction sendFunction);
+    ~SysExSender() override;
+
+    /** Sets the maximum number of bytes per second to send. */
+    void setBytesPerSecond (int newBytesPerSecond) noexcept;
+
+    /** Sets a minimum gap in milliseconds between packets. */
+    void setPacketInterval (int milliseconds) noexcept;
+
+    /** Starts sending the packets. Returns false if already sending. */
+    bool send (juce::Array<juce::MidiMessage> packets);
+
+    /** Starts sending from a source. Returns false if already sending. */
+    bool send (std::unique_ptr<Source> source);
+
+    /** Returns true while packets are being sent. */
+    bool isSending() const noexcept { return isThreadRunning(); }
+
+    /** Stops sending and waits for the thread to exit. */
+    void cancel();
+
+    /** Returns the number of bytes sent so far by the current or last transfer. */
+    juce::int64 getBytesSent() const noexcept { return bytesSent.load(); }
+    /** Returns the total size of the current or last transfer. */
+    juce::int64 getTotalBytes() const noexcept { return totalBytes.load(); }
+    /** Returns the progress of the current or last transfer, 0 to 1. */
+    double getProgress() const noexcept;
+    /** Returns the average throughput of the current or last transfer. */
+    double getThroughput() const noexcept;
+
+private:
+    SendFunction sendFunction;
+    std::unique_ptr<Source> source;
+    std::atomic<int> bytesPerSecond { 3125 }; // 31250 baud, 10 bits per byte
+    std::atomic<int> packetInterval { 0 };
+    std::atomic<juce::int64> bytesSent { 0 }, totalBytes { 0 };
+    std::atomic<double> startTime { 0.0 }, endTime { 0.0 };
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE (SysExSender)
+};
+
+} // namespace vmc
@@ -0,0 +1,170 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <iostream>
+#include <thread>
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "controller.hpp"
+#include "midisender.hpp"
+#include "midisink.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int testTimeoutMs = 5000;
+
+/** Waits until a sink has received a number of messages, returns false on timeout. */
+static bool waitForSink (const MidiSink& sink, juce::int64 count)
+{
+    const auto end = juce::Time::getMillisecondCounter() + (juce::uint32) testTimeoutMs;
+    while (sink.getNumReceived() < count) {
+        if (juce::Time::getMillisecondCounter() >= end)
+            return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/** A temporary folder for a controller's settings, so tests never read or
+    change the user's. Removed when it goes out of scope.
+*/
+struct ScratchSettings final {
+    ScratchSettings() { folder.createDirectory(); }
+    ~ScratchSettings() { folder.deleteRecursively(); }
+
+    juce::PropertiesFile::Options getOptions() const { return Settings::getOptionsInFolder (folder); }
+
+    const juce::File folder { juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                  .getNonexistentChildFile ("vmc-test-settings", {}, false) };
+};
+} // namespace detail
+
+/** Sends through a controller into a loopback sink and checks what arrived. */
+class LoopbackMidiSinkTest final : public juce::UnitTest {
+public:
+    LoopbackMidiSinkTest() : juce::UnitTest ("LoopbackMidiSink", "vmc") {}
+
+    void runTest() override
+    {
+        beginTest ("Messages arrive in order with their timestamps");
+        {
+            const int numMessages = 1000;
+            auto sink = std::make_unique<LoopbackMidiSink> (numMessages);
+            auto& loopback = *sink;
+            detail::ScratchSettings settings;
+            Controller controller (std::move (sink), settings.getOptions());
+
+            std::vector<double> sent;
+            for (int i = 0; i < numMessages; ++i) {
+                const auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+                sent.push_back (now);
+                controller.addMidiMessage (juce::MidiMessage::controllerEvent (1, i % 128, (i / 128) % 128).withTimeStamp (now));
+            }
+
+            expect (loopback.waitForMessages (numMessages, detail::testTimeoutMs));
+            expectEquals (loopback.getNumReceived(), (juce::int64) numMessages);
+            expectEquals (loopback.getNumEvents(), numMessages);
+
+            double lastReceived = 0.0;
+            for (int i = 0; i < loopback.getNumEvents(); ++i) {
+                const auto& event = loopback.getEvent (i);
+                expect (event.message.isController());
+                expectEquals (event.message.getControllerNumber(), i % 128);
+                expectEquals (event.message.getControllerValue(), (i / 128) % 128);
+                expectEquals (event.message.getTimeStamp(), sent[(size_t) i]);
+                expect (event.received >= event.message.getTimeStamp());
+                expect (event.received >= lastReceived);
+                expect (event.getLatency() >= 0.0);
+                lastReceived = event.received;
+            }
+        }
+
+        beginTest ("A buffer arrives back to back");
+        {
+            auto sink = std::make_unique<LoopbackMidiSink>();
+            auto& loopback = *sink;
+            detail::ScratchSettings settings;
+            Controller controller (std::move (sink), settings.getOptions());
+
+            juce::MidiBuffer buffer;
+            for (int note = 60; note < 72; ++note)
+                buffer.addEvent (juce::MidiMessage::noteOn (1, note, (juce::uint8) 100), note - 60);
+            controller.addMidiBuffer (buffer);
+
+            expect (loopback.waitForMessages (12, detail::testTimeoutMs));
+            expectEquals (loopback.getNumEvents(), 12);
+            for (int i = 0; i < loopback.getNumEvents(); ++i)
+                expectEquals (loopback.getEvent (i).message.getNoteNumber(), 60 + i);
+        }
+
+        beginTest ("Recording stops at the capacity, the count doesn't");
+        {
+            auto sink = std::make_unique<LoopbackMidiSink> (16);
+            auto& loopback = *sink;
+            detail::ScratchSettings settings;
+            Controller controller (std::move (sink), settings.getOptions());
+
+            for (int i = 0; i < 32; ++i)
+                controller.addMidiMessage (juce::MidiMessage::controllerEvent (1, 1, i));
+
+            expect (loopback.waitForMessages (32, detail::testTimeoutMs));
+            expectEquals (loopback.getNumReceived(), (juce::int64) 32);
+            expectEquals (loopback.getNumEvents(), 16);
+            for (int i = 0; i < loopback.getNumEvents(); ++i)
+                expectEquals (loopback.getEvent (i).message.getControllerValue(), i);
+
+            loopback.clear();
+            expectEquals (loopback.getNumReceived(), (juce::int64) 0);
+            expectEquals (loopback.getNumEvents(), 0);
+        }
+    }
+};
+
+/** Sends through a controller into a null sink and checks the counts. */
+class NullMidiSinkTest final : public juce::UnitTest {
+public:
+    NullMidiSinkTest() : juce::UnitTest ("NullMidiSink", "vmc") {}
+
+    void runTest() override
+    {
+        beginTest ("Every message is counted");
+        {
+            const int numMessages = 5000;
+            detail::ScratchSettings settings;
+            Controller controller (std::make_unique<NullMidiSink>(), settings.getOptions());
+            auto& sender = controller.getMidiSender();
+
+            for (int i = 0; i < numMessages; ++i) {
+                // The sender may fall behind, retry until there is room.
+                const auto msg = juce::MidiMessage::controllerEvent (1, i % 128, i % 128);
+                while (! sender.add (msg))
+                    std::this_thread::yield();
+            }
+
+            expect (detail::waitForSink (controller.getMidiSink(), numMessages));
+            expectEquals (controller.getMidiSink().getNumReceived(), (juce::int64) numMessages);
+        }
+    }
+};
+
+static LoopbackMidiSinkTest loopbackMidiSinkTest;
+static NullMidiSinkTest nullMidiSinkTest;
+
+} // namespace vmc
+
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI gui;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory ("vmc");
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult (i)->failures;
+
+    std::cout << "vmc-tests: " << numFailures << " failures" << std::endl;
+    return numFailures > 0 ? 1 : 0;
+}
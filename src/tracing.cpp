@@ -0,0 +1,230 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "tracing.hpp"
+
+namespace vmc {
+namespace detail {
+static constexpr int traceBufferSize = 1 << 16;
+
+struct TraceSpan {
+    const char* name;
+    juce::int64 start;
+    juce::int64 end;
+};
+
+struct TraceBuffer {
+    std::vector<TraceSpan> spans;
+    std::atomic<int> count { 0 };
+    std::atomic<juce::int64> dropped { 0 };
+    // The recording the count belongs to, written by the owning thread.
+    std::atomic<int> generation { -1 };
+    int threadIndex = 0;
+    juce::String threadName;
+    bool inUse = false;
+};
+
+struct TraceRegistry {
+    juce::CriticalSection lock;
+    // Buffers outlive their threads so spans can still be written out, then
+    // they are reused by new threads.
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    juce::int64 startTicks = 0;
+
+    static TraceRegistry& get()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+};
+
+/** Hands the thread's buffer back when the thread ends. */
+struct ThreadBufferLease {
+    TraceBuffer* buffer = nullptr;
+
+    ~ThreadBufferLease()
+    {
+        if (buffer == nullptr)
+            return;
+        auto& registry = TraceRegistry::get();
+        const juce::ScopedLock sl (registry.lock);
+        buffer->inUse = false;
+    }
+};
+
+static thread_local ThreadBufferLease threadBuffer;
+
+static juce::String getCurrentThreadName()
+{
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        return "Message Thread";
+    if (auto* thread = juce::Thread::getCurrentThread())
+        return thread->getThreadName();
+    return "Thread " + juce::String::toHexString ((juce::pointer_sized_int) juce::Thread::getCurrentThreadId());
+}
+
+static TraceBuffer& getThreadBuffer (int generation)
+{
+    if (threadBuffer.buffer != nullptr)
+        return *threadBuffer.buffer;
+
+    auto name = getCurrentThreadName();
+    auto& registry = TraceRegistry::get();
+    const juce::ScopedLock sl (registry.lock);
+
+    for (auto& buffer : registry.buffers) {
+        // One that ended during this recording keeps its spans for writing out.
+        if (buffer->inUse || (buffer->generation.load() == generation && buffer->count.load() > 0))
+            continue;
+        buffer->count = 0;
+        buffer->dropped = 0;
+        buffer->generation = generation;
+        buffer->threadName = std::move (name);
+        buffer->inUse = true;
+        threadBuffer.buffer = buffer.get();
+        return *buffer;
+    }
+
+    auto buffer = std::make_unique<TraceBuffer>();
+    buffer->spans.resize ((size_t) traceBufferSize);
+    buffer->generation = generation;
+    buffer->threadName = std::move (name);
+    buffer->threadIndex = (int) registry.buffers.size() + 1;
+    buffer->inUse = true;
+    threadBuffer.buffer = buffer.get();
+    registry.buffers.push_back (std::move (buffer));
+    return *threadBuffer.buffer;
+}
+
+/** Returns the spans a buffer holds for the current recording. */
+static int getCurrentCount (const TraceBuffer& buffer, int generation) noexcept
+{
+    return buffer.generation.load (std::memory_order_acquire) == generation ? buffer.count.load (std::memory_order_acquire) : 0;
+}
+
+static double ticksToMicros (juce::int64 ticks) noexcept
+{
+    return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+}
+} // namespace detail
+
+void TraceRecorder::start()
+{
+    auto& registry = detail::TraceRegistry::get();
+    const juce::ScopedLock sl (registry.lock);
+    recording = false;
+    // Counts aren't touched here, a thread could be in the middle of recording.
+    ++generation;
+    registry.startTicks = juce::Time::getHighResolutionTicks();
+    recording = true;
+}
+
+void TraceRecorder::stop()
+{
+    recording = false;
+}
+
+void TraceRecorder::setTrackingHandlers (bool shouldTrack) noexcept
+{
+    trackingHandlers += shouldTrack ? 1 : -1;
+}
+
+const char* TraceRecorder::enterHandler (const char* name) noexcept
+{
+    if (! juce::MessageManager::existsAndIsCurrentThread())
+        return notTracked;
+    return currentHandler.exchange (name, std::memory_order_acq_rel);
+}
+
+void TraceRecorder::exitHandler (const char* previous) noexcept
+{
+    currentHandler.store (previous, std::memory_order_release);
+}
+
+void TraceRecorder::record (const char* name, juce::int64 startTicks, juce::int64 endTicks)
+{
+    // Recording may have stopped since the span began.
+    if (! isRecording())
+        return;
+
+    const int current = generation.load (std::memory_order_acquire);
+    auto& buffer = detail::getThreadBuffer (current);
+    if (buffer.generation.load (std::memory_order_relaxed) != current) {
+        buffer.count.store (0, std::memory_order_relaxed);
+        buffer.dropped.store (0, std::memory_order_relaxed);
+        buffer.generation.store (current, std::memory_order_release);
+    }
+
+    const int index = buffer.count.load (std::memory_order_relaxed);
+    if (index >= (int) buffer.spans.size()) {
+        ++buffer.dropped;
+        return;
+    }
+
+    buffer.spans[(size_t) index] = { name, startTicks, endTicks };
+    buffer.count.store (index + 1, std::memory_order_release);
+}
+
+juce::int64 TraceRecorder::getNumSpans()
+{
+    auto& registry = detail::TraceRegistry::get();
+    const juce::ScopedLock sl (registry.lock);
+    const int current = generation.load();
+    juce::int64 total = 0;
+    for (const auto& buffer : registry.buffers)
+        total += detail::getCurrentCount (*buffer, current);
+    return total;
+}
+
+juce::int64 TraceRecorder::getNumDropped()
+{
+    auto& registry = detail::TraceRegistry::get();
+    const juce::ScopedLock sl (registry.lock);
+    const int current = generation.load();
+    juce::int64 total = 0;
+    for (const auto& buffer : registry.buffers)
+        if (buffer->generation.load (std::memory_order_acquire) == current)
+            total += buffer->dropped.load();
+    return total;
+}
+
+juce::String TraceRecorder::toChromeJson()
+{
+    auto& registry = detail::TraceRegistry::get();
+    const juce::ScopedLock sl (registry.lock);
+    const auto origin = detail::ticksToMicros (registry.startTicks);
+    const int current = generation.load();
+
+    juce::MemoryOutputStream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Virtual MIDI Controller\"}}";
+
+    for (const auto& buffer : registry.buffers) {
+        const int count = detail::getCurrentCount (*buffer, current);
+        if (count == 0)
+            continue;
+
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex
+            << ",\"args\":{\"name\":\"" << juce::JSON::escapeString (buffer->threadName) << "\"}}";
+
+        for (int i = 0; i < count; ++i) {
+            const auto& span = buffer->spans[(size_t) i];
+            const auto start = detail::ticksToMicros (span.start) - origin;
+            const auto duration = detail::ticksToMicros (span.end) - detail::ticksToMicros (span.start);
+            out << ",\n{\"name\":\"" << juce::JSON::escapeString (span.name)
+                << "\",\"cat\":\"vmc\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+                << ",\"ts\":" << juce::String (start, 3)
+                << ",\"dur\":" << juce::String (duration, 3) << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.toString();
+}
+
+bool TraceRecorder::writeChromeJson (const juce::File& file)
+{
+    return file.replaceWithText (toChromeJson());
+}
+
+} // namespace vmc
@@ -0,0 +1,102 @@
+// Copyright 2025 (c) Kushview, LLC
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "juce.hpp"
+
+#ifndef VMC_TRACING
+    #define VMC_TRACING 1
+#endif
+
+namespace vmc {
+
+/** Records timed spans from any thread and writes them as Chrome trace JSON,
+    which Perfetto and chrome://tracing can open.
+
+    Each thread writes to its own fixed size buffer without locking. The
+    buffer is made the first time a thread records while recording is on,
+    and when the thread ends it is given to the next new thread unless it
+    still holds spans from this recording. While off, a span costs two
+    relaxed atomic loads. Spans past a buffer's capacity are counted and
+    dropped.
+*/
+class TraceRecorder final {
+public:
+    /** Clears previous spans and starts recording. */
+    static void start();
+    /** Stops recording, the spans are kept until the next start. */
+    static void stop();
+    static bool isRecording() noexcept { return recording.load (std::memory_order_relaxed); }
+
+    /** Keeps the name of the innermost span running on the message thread,
+        for watchdogs to read from another thread. Calls nest.
+    */
+    static void setTrackingHandlers (bool shouldTrack) noexcept;
+    static bool isTrackingHandlers() noexcept { return trackingHandlers.load (std::memory_order_relaxed) > 0; }
+    /** Returns the innermost span running on the message thread, or null. */
+    static const char* getCurrentHandler() noexcept { return currentHandler.load (std::memory_order_acquire); }
+
+    /** Adds a span with times from Time::getHighResolutionTicks(). */
+    static void record (const char* name, juce::int64 startTicks, juce::int64 endTicks);
+
+    /** Returns the number of spans recorded and dropped since the last start. */
+    static juce::int64 getNumSpans();
+    static juce::int64 getNumDropped();
+
+    /** Returns the recorded spans as Chrome trace JSON. */
+    static juce::String toChromeJson();
+    /** Writes the recorded spans to a file as Chrome trace JSON. */
+    static bool writeChromeJson (const juce::File& file);
+
+private:
+    friend class TraceScope;
+    static inline const char notTracked[] = "";
+    static inline std::atomic<bool> recording { false };
+    // Bumped by start(), each thread clears its own buffer when it sees a new one.
+    static inline std::atomic<int> generation { 0 };
+    static inline std::atomic<int> trackingHandlers { 0 };
+    static inline std::atomic<const char*> currentHandler { nullptr };
+
+    static const char* enterHandler (const char* name) noexcept;
+    static void exitHandler (const char* previous) noexcept;
+
+    TraceRecorder() = delete;
+};
+
+/** Records the time from construction to destruction as a span. The name
+    must be a string literal, or otherwise outlive the recording.
+*/
+class TraceScope final {
+public:
+    explicit TraceScope (const char* spanName) noexcept
+        : name (spanName),
+          start (TraceRecorder::isRecording() ? juce::Time::getHighResolutionTicks() : 0)
+    {
+        if (TraceRecorder::isTrackingHandlers())
+            previous = TraceRecorder::enterHandler (name);
+    }
+
+    ~TraceScope()
+    {
+        if (start != 0)
+            TraceRecorder::record (name, start, juce::Time::getHighResolutionTicks());
+        if (previous != TraceRecorder::notTracked)
+            TraceRecorder::exitHandler (previous);
+    }
+
+private:
+    const char* const name;
+    const juce::int64 start;
+    const char* previous = TraceRecorder::notTracked;
+    JUCE_DECLARE_NON_COPYABLE (TraceScope)
+};
+
+} // namespace vmc
+
+#if VMC_TRACING
+    /** Traces the rest of the enclosing scope under a name. */
+    #define VMC_TRACE_SCOPE(name) const vmc::TraceScope JUCE_JOIN_MACRO (vmcTraceScope, __LINE__) (name)
+#else
+    #define VMC_TRACE_SCOPE(name)
+#endif
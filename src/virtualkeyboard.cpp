@@ -2,16 +2,90 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "virtualkeyboard.hpp"
+#include "tracing.hpp"
 
 namespace vmc {
 
 MidiKeyboard::MidiKeyboard (juce::MidiKeyboardState& state, Orientation orientation)
     : juce::MidiKeyboardComponent (state, orientation)
 {
+    // Keys cover the whole area, nothing behind needs painting.
+    setOpaque (true);
+}
+
+void MidiKeyboard::paint (juce::Graphics& g)
+{
+    VMC_TRACE_SCOPE ("MidiKeyboard::paint");
+    ScopedPaintTimer timer (paintStats);
+    juce::MidiKeyboardComponent::paint (g);
+}
+
+void MidiKeyboard::setUseSprites (bool shouldUseSprites)
+{
+    if (useSprites == shouldUseSprites)
+        return;
+    useSprites = shouldUseSprites;
+    whiteSprites = {};
+    blackSprites = {};
+    repaint();
 }
 
 void MidiKeyboard::drawWhiteNote (int midiNoteNumber, juce::Graphics& g, juce::Rectangle<float> area,
                                   bool isDown, bool isOver, juce::Colour lineColour, juce::Colour textColour)
+{
+    if (! g.clipRegionIntersects (area.getSmallestIntegerContainer()))
+        return;
+
+    if (useSprites)
+        drawSprite (g, whiteSprites, area, isDown, isOver, paintWhiteKey);
+    else
+        paintWhiteKey (g, area, isDown, isOver);
+}
+
+void MidiKeyboard::drawBlackNote (int midiNoteNumber, juce::Graphics& g, juce::Rectangle<float> area,
+                                  bool isDown, bool isOver, juce::Colour noteFillColour)
+{
+    if (! g.clipRegionIntersects (area.getSmallestIntegerContainer()))
+        return;
+
+    if (useSprites)
+        drawSprite (g, blackSprites, area, isDown, isOver, paintBlackKey);
+    else
+        paintBlackKey (g, area, isDown, isOver);
+}
+
+void MidiKeyboard::drawSprite (juce::Graphics& g, Sprites& sprites, juce::Rectangle<float> area,
+                               bool isDown, bool isOver, KeyPainter paintKey)
+{
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const auto size = area.withZeroOrigin();
+
+    if (sprites.scale != scale || sprites.size != size) {
+        // Every key of a kind is the same size, render each state once.
+        sprites.scale = scale;
+        sprites.size = size;
+        for (int state = 0; state < numKeyStates; ++state) {
+            auto& image = sprites.images[state];
+            image = juce::Image (juce::Image::ARGB,
+                                 juce::jmax (1, juce::roundToInt (size.getWidth() * scale)),
+                                 juce::jmax (1, juce::roundToInt (size.getHeight() * scale)),
+                                 true);
+            juce::Graphics ig (image);
+            ig.addTransform (juce::AffineTransform::scale (scale));
+            paintKey (ig, size, state == keyDown, state == keyOver);
+        }
+    }
+
+    const int state = isDown ? keyDown : (isOver ? keyOver : keyUp);
+    // Snap to physical pixels so the sprite is copied, not resampled.
+    const auto x = std::round (area.getX() * scale) / scale;
+    const auto y = std::round (area.getY() * scale) / scale;
+    g.setOpacity (1.0f);
+    g.drawImageTransformed (sprites.images[state],
+                            juce::AffineTransform::scale (1.0f / scale).translated (x, y));
+}
+
+void MidiKeyboard::paintWhiteKey (juce::Graphics& g, juce::Rectangle<float> area, bool isDown, bool isOver)
 {
     // White key background
     juce::Colour keyColour = juce::Colours::white;
@@ -39,8 +113,7 @@ void MidiKeyboard::drawWhiteNote (int midiNoteNumber, juce::Graphics& g, juce::R
     }
 }
 
-void MidiKeyboard::drawBlackNote (int midiNoteNumber, juce::Graphics& g, juce::Rectangle<float> area,
-                                  bool isDown, bool isOver, juce::Colour noteFillColour)
+void MidiKeyboard::paintBlackKey (juce::Graphics& g, juce::Rectangle<float> area, bool isDown, bool isOver)
 {
     // Black key background - match the aluminum theme's dark colors
     juce::Colour keyColour = juce::Colour::fromRGB (28, 28, 28);
@@ -6,19 +6,58 @@
 #include "juce.hpp"
 #include <juce_audio_utils/juce_audio_utils.h>
 
+#include "paintstats.hpp"
+
 namespace vmc {
 
 // Custom MIDI keyboard component with aluminum theme styling
+//
+// Keys are drawn from sprites rendered once per key size and display scale,
+// and keys outside the area being repainted are skipped.
 class MidiKeyboard : public juce::MidiKeyboardComponent {
 public:
     MidiKeyboard (juce::MidiKeyboardState& state, Orientation orientation);
 
+    void paint (juce::Graphics& g) override;
+
+    /** Draws keys from cached sprites, or from scratch when false. */
+    void setUseSprites (bool shouldUseSprites);
+    bool isUsingSprites() const noexcept { return useSprites; }
+
+    /** Returns the paint timing of the keyboard. */
+    PaintStats& getPaintStats() noexcept { return paintStats; }
+
     // Override the drawing methods to match our aluminum theme
     void drawWhiteNote (int midiNoteNumber, juce::Graphics& g, juce::Rectangle<float> area,
                         bool isDown, bool isOver, juce::Colour lineColour, juce::Colour textColour) override;
 
     void drawBlackNote (int midiNoteNumber, juce::Graphics& g, juce::Rectangle<float> area,
                         bool isDown, bool isOver, juce::Colour noteFillColour) override;
+
+private:
+    enum KeyState {
+        keyUp = 0,
+        keyDown,
+        keyOver,
+        numKeyStates
+    };
+
+    using KeyPainter = void (*) (juce::Graphics&, juce::Rectangle<float>, bool isDown, bool isOver);
+
+    struct Sprites {
+        juce::Image images[numKeyStates];
+        juce::Rectangle<float> size;
+        float scale = 0.0f;
+    };
+
+    Sprites whiteSprites, blackSprites;
+    bool useSprites = true;
+    PaintStats paintStats;
+
+    static void paintWhiteKey (juce::Graphics& g, juce::Rectangle<float> area, bool isDown, bool isOver);
+    static void paintBlackKey (juce::Graphics& g, juce::Rectangle<float> area, bool isDown, bool isOver);
+    static void drawSprite (juce::Graphics& g, Sprites& sprites, juce::Rectangle<float> area,
+                            bool isDown, bool isOver, KeyPainter paintKey);
 };
 
 class VirtualKeyboard : public Component {
@@ -29,6 +68,10 @@ public:
         addAndMakeVisible (keyboard.get());
         keyboard->setKeyWidth (32);
         keyboard->setScrollButtonWidth (22);
+
+        // Computer keyboard notes are played by QwertyNoteInput.
+        keyboard->clearKeyMappings();
+        keyboard->setWantsKeyboardFocus (false);
     }
 
     ~VirtualKeyboard()